@@ -68,6 +68,7 @@ namespace {
         return slideAttacks(s, occ, RDirections);
     }
 
+#if !defined(USE_COMPACT_ATTACKS)
     // Max Bishop Table Size
     // 4 * 2^6 + 12 * 2^7 + 44 * 2^5 + 4 * 2^9
     // 4 *  64 + 12 * 128 + 44 *  32 + 4 * 512
@@ -79,6 +80,15 @@ namespace {
     // 4 * 4096 + 24 * 2048 + 36 * 1024
     //    16384 +     49152 +     36864 = 102400
     Bitboard RAttacks[0x19000];
+#else
+    // Unique attack sets of all squares: 1428 for bishop, 4900 for rook
+    Bitboard BAttackSets[0x594];
+    Bitboard RAttackSets[0x1324];
+
+    // 8-bit indices of the unique attack sets of the square
+    uint8_t BIndices[0x1480];
+    uint8_t RIndices[0x19000];
+#endif
 
     /// Initialize all bishop and rook attacks at startup.
     /// Magic bitboards are used to look up attacks of sliding pieces.
@@ -183,6 +193,49 @@ namespace {
 #endif
         }
     }
+
+#if defined(USE_COMPACT_ATTACKS)
+    /// Compact the full attacks tables filled by initializeMagic() into the unique attack sets
+    /// of each square, the magic index now selects the set through an 8-bit index.
+    template<PieceType PT>
+    void compactMagic(Bitboard attackSets[], uint8_t indices[], Magic magics[]) noexcept {
+
+        uint32_t offset{ 0 };
+        uint16_t count{ 0 };
+        for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+
+            Magic &magic{ magics[s] };
+
+            Bitboard const *const attacks{ magic.attacks };
+            magic.attacks = attackSets + count;
+            magic.indices = indices + offset;
+
+            uint8_t size{ 0 };
+            // Only the indices of the subsets of magic.mask are used (without BMI2 some others stay zero)
+            Bitboard occ{ 0 };
+            do {
+                auto const idx{ magic.index(occ) };
+                auto const attack{ attacks[idx] };
+
+                uint8_t i{ 0 };
+                while (i < size
+                    && magic.attacks[i] != attack) {
+                    ++i;
+                }
+                if (i == size) {
+                    magic.attacks[size++] = attack;
+                }
+                magic.indices[idx] = i;
+
+                occ = (occ - magic.mask) & magic.mask;
+            } while (occ != 0);
+
+            assert(size <= 144);
+            count  += size;
+            offset += 1 << popCount(magic.mask);
+        }
+    }
+#endif
 }
 
 namespace Bitboards {
@@ -206,8 +259,19 @@ namespace Bitboards {
 #endif
 
         // Initialize Magic Table
+#if defined(USE_COMPACT_ATTACKS)
+        {
+            // The full tables are needed only to be compacted
+            std::vector<Bitboard> attacks(0x19000);
+            initializeMagic<BSHP>(attacks.data(), BMagics);
+            compactMagic<BSHP>(BAttackSets, BIndices, BMagics);
+            initializeMagic<ROOK>(attacks.data(), RMagics);
+            compactMagic<ROOK>(RAttackSets, RIndices, RMagics);
+        }
+#else
         initializeMagic<BSHP>(BAttacks, BMagics);
         initializeMagic<ROOK>(RAttacks, RMagics);
+#endif
 
         // Pawn and Pieces Attack Table
         for (Square s = SQ_A1; s <= SQ_H8; ++s) {
@@ -245,6 +309,16 @@ namespace Bitboards {
 
     }
 
+    /// attacksSize() returns the size in bytes of the slider attacks tables
+    size_t attacksSize() noexcept {
+#if defined(USE_COMPACT_ATTACKS)
+        return sizeof(BAttackSets) + sizeof(RAttackSets)
+             + sizeof(BIndices) + sizeof(RIndices);
+#else
+        return sizeof(BAttacks) + sizeof(RAttacks);
+#endif
+    }
+
 #if !defined(NDEBUG)
     /// Returns an ASCII representation of a bitboard to print on console output
     /// Bitboard in an easily readable format. This is sometimes useful for debugging.
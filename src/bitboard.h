@@ -7,6 +7,9 @@
 #include "type.h"
 
 // Magic holds all magic relevant data for a single square
+// With USE_COMPACT_ATTACKS the index selects through an 8-bit indirection table
+// one of the unique attack sets of the square (at most 144 for rook, 108 for bishop),
+// which shrinks the slider tables from about 840 KB to about 155 KB.
 struct Magic {
 
     // Compute the attack's index using the 'magic bitboards' approach
@@ -24,10 +27,17 @@ struct Magic {
 
     // Return attacks
     Bitboard attacksBB(Bitboard occ) const noexcept {
+    #if defined(USE_COMPACT_ATTACKS)
+        return attacks[indices[index(occ)]];
+    #else
         return attacks[index(occ)];
+    #endif
     }
 
     Bitboard *attacks;
+#if defined(USE_COMPACT_ATTACKS)
+    uint8_t  *indices;
+#endif
     Bitboard  mask;
 
 #if !defined(USE_BMI2)
@@ -382,6 +392,8 @@ namespace Bitboards {
 
     extern void initialize() noexcept;
 
+    extern size_t attacksSize() noexcept;
+
 #if !defined(NDEBUG)
     extern std::string toString(Bitboard) noexcept;
 #endif
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "type.h"
+
+/// EvalParameters holds all the table parameters of the classical evaluation in one
+/// cache-line aligned block instead of scattered arrays over several translation units,
+/// so that an evaluation touches as few cache lines as possible.
+/// Tables are ordered hot-first:
+/// - used by every (non-lazy) evaluation: Mobility, Threats, Passer, BishopPawns, King-attack weights
+/// - used only on King entry miss: Shelter, Storm, KingOnFile
+/// - used only on Pawn entry miss: Connected, BlockedPawn
+/// Empty rows of the piece-type indexed tables are dropped (Mobility is indexed by [PT - NIHT]).
+/// Single scores stay as constexpr in their files, they are encoded as immediates.
+///
+/// A binary built with EVAL_TUNE (make evaltune=yes) has writable tables, registered with TUNE()
+/// in evaluator.cpp, for the tune command and the SPSA options.
+struct alignas(64) EvalParameters {
+
+#define S(mg, eg) makeScore(mg, eg)
+
+    Score Mobility[QUEN - NIHT + 1][28]{
+        {   S(-62,-79), S(-53,-57), S(-12,-31), S( -3,-17), S(  3,  7), S( 12, 13), // Knight
+            S( 21, 16), S( 28, 21), S( 37, 26) },
+        {   S(-47,-59), S(-20,-25), S( 14, -8), S( 29, 12), S( 39, 21), S( 53, 40), // Bishop
+            S( 53, 56), S( 60, 58), S( 62, 65), S( 69, 72), S( 78, 78), S( 83, 87),
+            S( 91, 88), S( 96, 98) },
+        {   S(-61,-82), S(-20,-17), S(  2, 23) ,S(  3, 40), S(  4, 72), S( 11,100), // Rook
+            S( 22,104), S( 31,120), S( 39,134), S(40 ,138), S( 41,158), S( 47,163),
+            S( 59,168), S( 60,169), S( 64,173) },
+        {   S(-29,-49), S(-16,-29), S( -8, -8), S( -8, 17), S( 18, 39), S( 25, 54), // Queen
+            S( 23, 59), S( 37, 73), S( 41, 76), S( 54, 95), S( 65, 95) ,S( 68,101),
+            S( 69,124), S( 70,128), S( 70,132), S( 70,133) ,S( 71,136), S( 72,140),
+            S( 74,147), S( 76,149), S( 90,153), S(104,169), S(105,171), S(106,171),
+            S(112,178), S(114,185), S(114,187), S(119,221) },
+    };
+
+    // MinorThreat[attacked PieceType] contains bonuses for minor according to which piece type attacks which one
+    Score MinorThreat[PIECE_TYPES_EX]{
+        S( 0, 0), S( 5,32), S(55,41), S(77,56), S(89,119), S(79,162)
+    };
+    // MajorThreat[attacked PieceType] contains bonuses for rook according to which piece type attacks which one
+    Score MajorThreat[PIECE_TYPES_EX]{
+        S( 0, 0), S( 3,44), S(37,68), S(42,60), S( 0, 39), S(58, 43)
+    };
+    // Passer[Rank] contains a bonus according to the rank of a passed pawn
+    Score Passer[RANKS]{
+        S( 0, 0), S( 9,28), S(15,31), S(17,39), S(64,70), S(171,177), S(277,260), S( 0, 0)
+    };
+
+    Score BishopPawns[FILES / 2]{
+        S(3, 8), S(3, 9), S(1, 8), S(3, 7)
+    };
+
+    int32_t KingAttackerWeight[PIECE_TYPES_EX]{
+        0, 0, 81, 52, 44, 10
+    };
+    int32_t SafeCheckWeight[PIECE_TYPES_EX][2]{
+        {0,0}, {0,0}, {803, 1292}, {639, 974}, {1087, 1878}, {759, 1132}
+    };
+
+    // Safety of friend pawns shelter for our king by [distance from edge][rank].
+    // RANK_1 is used for files where we have no pawn, or pawn is behind our king.
+    Score Shelter[FILES/2][RANKS]{
+        { S( -5, 0), S( 82, 0), S( 92, 0), S( 54, 0), S( 36, 0), S( 22, 0), S(  28, 0), S(0, 0) },
+        { S(-44, 0), S( 63, 0), S( 33, 0), S(-50, 0), S(-30, 0), S(-12, 0), S( -62, 0), S(0, 0) },
+        { S(-11, 0), S( 77, 0), S( 22, 0), S( -6, 0), S( 31, 0), S(  8, 0), S( -45, 0), S(0, 0) },
+        { S(-39, 0), S(-12, 0), S(-29, 0), S(-50, 0), S(-43, 0), S(-68, 0), S(-164, 0), S(0, 0) }
+    };
+
+    // Danger of unblocked enemy pawns storm toward our king by [distance from edge][rank].
+    // RANK_1 is used for files where the enemy has no pawn, or their pawn is behind our king.
+    // [0][1 - 2] accommodate opponent pawn on edge (likely blocked by king)
+    Score UnblockedStorm[FILES/2][RANKS]{
+        { S( 87, 0), S(-288, 0), S(-168, 0), S( 96, 0), S( 47, 0), S( 44, 0), S( 46, 0), S(0, 0) },
+        { S( 42, 0), S( -25, 0), S( 120, 0), S( 45, 0), S( 34, 0), S( -9, 0), S( 24, 0), S(0, 0) },
+        { S( -8, 0), S(  51, 0), S( 167, 0), S( 35, 0), S( -4, 0), S(-16, 0), S(-12, 0), S(0, 0) },
+        { S(-17, 0), S( -13, 0), S( 100, 0), S(  4, 0), S(  9, 0), S(-16, 0), S(-31, 0), S(0, 0) }
+    };
+
+    Score BlockedStorm[RANKS]{
+        S( 0, 0), S( 0, 0), S( 76, 78), S(-10, 15), S(-7, 10), S(-4, 6), S(-1, 2), S( 0, 0)
+    };
+
+    // KingOnFile[semi-open Us][semi-open Them] contains bonuses/penalties
+    // for king when the king is on a semi-open or open file.
+    Score KingOnFile[2][2]{
+        { S(-19, 12), S(-6,  7) },
+        { S(  0,  2), S( 6, -5) }
+    };
+
+    // Connected pawn bonus
+    int32_t Connected[RANKS]{
+        0, 5, 7, 11, 24, 48, 86, 0
+    };
+
+    // Bonus for blocked pawns at 5th or 6th rank
+    Score BlockedPawn[2]{
+        S(-13, -4), S(-5, 2)
+    };
+
+#undef S
+
+};
+
+#if defined(EVAL_TUNE)
+extern EvalParameters EvalParams;
+#else
+inline constexpr EvalParameters EvalParams{};
+#endif
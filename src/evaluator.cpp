@@ -10,12 +10,14 @@
 #include <vector>
 
 #include "bitboard.h"
+#include "evalparam.h"
 #include "king.h"
 #include "material.h"
 #include "pawns.h"
 #include "position.h"
 #include "notation.h"
 #include "thread.h"
+#include "tune.h"
 #include "uci.h"
 #include "incbin/incbin.h"
 #include "helper/commandline.h"
@@ -35,6 +37,15 @@
     const unsigned int         gEmbeddedNNUESize   { 1 };
 #endif
 
+#if defined(EVAL_TUNE)
+EvalParameters EvalParams;
+
+TUNE(EvalParams.Mobility, EvalParams.MinorThreat, EvalParams.MajorThreat, EvalParams.Passer, EvalParams.BishopPawns,
+     EvalParams.KingAttackerWeight, EvalParams.SafeCheckWeight,
+     EvalParams.Shelter, EvalParams.UnblockedStorm, EvalParams.BlockedStorm, EvalParams.KingOnFile,
+     EvalParams.Connected, EvalParams.BlockedPawn);
+#endif
+
 
 namespace Evaluator {
 
@@ -98,7 +109,7 @@ namespace Evaluator {
                         << "info string ERROR: The default net can be downloaded from: https://tests.stockfishchess.org/api/nn/" << Options["Eval File"].defaultValue() << sync_endl;
                     std::exit(EXIT_FAILURE);
                 }
-                sync_cout << "info string NNUE evaluation using " << evalFile << " enabled." << sync_endl;
+                sync_cout << "info string NNUE evaluation using " << evalFile << " (" << architecture() << ") enabled." << sync_endl;
             } else {
                 sync_cout << "info string classical evaluation enabled." << sync_endl;
             }
@@ -184,41 +195,6 @@ namespace Evaluator {
 
     #define S(mg, eg) makeScore(mg, eg)
 
-        constexpr Score Mobility[PIECE_TYPES_EX][28]{
-            {},
-            {},
-            {   S(-62,-79), S(-53,-57), S(-12,-31), S( -3,-17), S(  3,  7), S( 12, 13), // Knight
-                S( 21, 16), S( 28, 21), S( 37, 26) },
-            {   S(-47,-59), S(-20,-25), S( 14, -8), S( 29, 12), S( 39, 21), S( 53, 40), // Bishop
-                S( 53, 56), S( 60, 58), S( 62, 65), S( 69, 72), S( 78, 78), S( 83, 87),
-                S( 91, 88), S( 96, 98) },
-            {   S(-61,-82), S(-20,-17), S(  2, 23) ,S(  3, 40), S(  4, 72), S( 11,100), // Rook
-                S( 22,104), S( 31,120), S( 39,134), S(40 ,138), S( 41,158), S( 47,163),
-                S( 59,168), S( 60,169), S( 64,173) },
-            {   S(-29,-49), S(-16,-29), S( -8, -8), S( -8, 17), S( 18, 39), S( 25, 54), // Queen
-                S( 23, 59), S( 37, 73), S( 41, 76), S( 54, 95), S( 65, 95) ,S( 68,101),
-                S( 69,124), S( 70,128), S( 70,132), S( 70,133) ,S( 71,136), S( 72,140),
-                S( 74,147), S( 76,149), S( 90,153), S(104,169), S(105,171), S(106,171),
-                S(112,178), S(114,185), S(114,187), S(119,221) },
-        };
-
-        // ThreatByMinor[attacked PieceType] contains bonuses for minor according to which piece type attacks which one
-        constexpr Score MinorThreat[PIECE_TYPES_EX]{
-            S( 0, 0), S( 5,32), S(55,41), S(77,56), S(89,119), S(79,162)
-        };
-        // ThreatByMajor[attacked PieceType] contains bonuses for rook according to which piece type attacks which one
-        constexpr Score MajorThreat[PIECE_TYPES_EX]{
-            S( 0, 0), S( 3,44), S(37,68), S(42,60), S( 0, 39), S(58, 43)
-        };
-        // Passer[Rank] contains a bonus according to the rank of a passed pawn
-        constexpr Score Passer[RANKS]{
-            S( 0, 0), S( 9,28), S(15,31), S(17,39), S(64,70), S(171,177), S(277,260), S( 0, 0)
-        };
-
-        constexpr Score BishopPawns[FILES / 2]{
-            S(3, 8), S(3, 9), S(1, 8), S(3, 7)
-        };
-
         constexpr Score MinorBehindPawn   { S( 18,  3) };
         constexpr Score KnightOutpost     { S( 56, 34) };
         constexpr Score KnightBadOutpost  { S( -7, 36) };
@@ -256,13 +232,6 @@ namespace Evaluator {
         constexpr Value NNUEThreshold1{   Value(550) };
         constexpr Value NNUEThreshold2{   Value(150) };
 
-        constexpr int32_t SafeCheckWeight[PIECE_TYPES_EX][2]{
-            {0,0}, {0,0}, {803, 1292}, {639, 974}, {1087, 1878}, {759, 1132}
-        };
-        constexpr int32_t KingAttackerWeight[PIECE_TYPES_EX]{
-            0, 0, 81, 52, 44, 10
-        };
-
         // Evaluator class contains various evaluation functions.
         template<bool Trace>
         class Evaluation {
@@ -406,7 +375,7 @@ namespace Evaluator {
 
                 if ((kingRing[Opp] & attacks) != 0) {
                     kingAttackersCount [Own]++;
-                    kingAttackersWeight[Own] += KingAttackerWeight[PT];
+                    kingAttackersWeight[Own] += EvalParams.KingAttackerWeight[PT];
                     kingAttacksCount   [Own] += popCount(attacks & attackedBy[Opp][KING]);
                 } else
                 if (PT == BSHP
@@ -421,7 +390,7 @@ namespace Evaluator {
                 auto const mob{ popCount(attacks & mobArea[Own]) };
 
                 // Bonus for piece mobility
-                mobility[Own] += Mobility[PT][mob];
+                mobility[Own] += EvalParams.Mobility[PT - NIHT][mob];
 
                 Bitboard b;
                 // Special evaluation for pieces
@@ -481,7 +450,7 @@ namespace Evaluator {
                         // less when the bishop is protected by pawn
                         // more when the center files are blocked with pawns.
                         Bitboard const blockedPawns{ pos.pieces(Own, PAWN) & pawnSglPushBB<Opp>(pos.pieces()) };
-                        score -= BishopPawns[edgeDistance(sFile(s))]
+                        score -= EvalParams.BishopPawns[edgeDistance(sFile(s))]
                                * popCount(pos.pawnsOnColor(Own, s))
                                * (popCount(blockedPawns & slotFileBB(CS_CENTRE))
                                 + !contains(attackedBy[Own][PAWN], s));
@@ -615,7 +584,7 @@ namespace Evaluator {
               & safeArea };
 
             if (rookSafeChecks != 0) {
-                kingDanger += SafeCheckWeight[ROOK][moreThanOne(rookSafeChecks)];
+                kingDanger += EvalParams.SafeCheckWeight[ROOK][moreThanOne(rookSafeChecks)];
             } else {
                 unsafeCheck |= rookPins
                              & attackedBy[Opp][ROOK];
@@ -630,7 +599,7 @@ namespace Evaluator {
               & ~rookSafeChecks };
 
             if (quenSafeChecks != 0) {
-                kingDanger += SafeCheckWeight[QUEN][moreThanOne(quenSafeChecks)];
+                kingDanger += EvalParams.SafeCheckWeight[QUEN][moreThanOne(quenSafeChecks)];
             }
 
             // Enemy bishops checks
@@ -641,7 +610,7 @@ namespace Evaluator {
               & ~quenSafeChecks };
 
             if (bshpSafeChecks != 0) {
-                kingDanger += SafeCheckWeight[BSHP][moreThanOne(bshpSafeChecks)];
+                kingDanger += EvalParams.SafeCheckWeight[BSHP][moreThanOne(bshpSafeChecks)];
             } else {
                 unsafeCheck |= bshpPins
                              & attackedBy[Opp][BSHP];
@@ -654,7 +623,7 @@ namespace Evaluator {
               & safeArea };
 
             if (nihtSafeChecks != 0) {
-                kingDanger += SafeCheckWeight[NIHT][moreThanOne(nihtSafeChecks)];
+                kingDanger += EvalParams.SafeCheckWeight[NIHT][moreThanOne(nihtSafeChecks)];
             } else {
                 unsafeCheck |= attacksBB<NIHT>(kSq)
                              & attackedBy[Opp][NIHT];
@@ -757,7 +726,7 @@ namespace Evaluator {
                   &  (attackedBy[Own][NIHT]
                     | attackedBy[Own][BSHP]);
                 while (b != 0) {
-                    score += MinorThreat[pType(pos[popLSq(b)])];
+                    score += EvalParams.MinorThreat[pType(pos[popLSq(b)])];
                 }
 
                 if (attackedUndefendedEnemies != 0) {
@@ -765,7 +734,7 @@ namespace Evaluator {
                     b =  attackedUndefendedEnemies
                       &  attackedBy[Own][ROOK];
                     while (b != 0) {
-                        score += MajorThreat[pType(pos[popLSq(b)])];
+                        score += EvalParams.MajorThreat[pType(pos[popLSq(b)])];
                     }
 
                     // Enemies attacked by king
@@ -883,7 +852,7 @@ namespace Evaluator {
 
                 int32_t const r{ relativeRank(Own, s) };
                 // Base bonus depending on rank.
-                Score bonus{ Passer[r] };
+                Score bonus{ EvalParams.Passer[r] };
 
                 auto const pushSq{ s + PawnPush[Own] };
                 if (r > RANK_3) {
@@ -1125,6 +1094,12 @@ namespace Evaluator {
         }
     }
 
+    /// imbalanced() tells whether the PSQ imbalance is large enough for evaluate() to use the classical evaluation
+    bool imbalanced(Position const &pos) {
+        Value const psq{ Value(std::abs(egValue(pos.psqScore()))) };
+        return psq * 16 > (NNUEThreshold1 + pos.nonPawnMaterial() / 64) * (16 + pos.clockPly());
+    }
+
     /// evaluate() returns a static evaluation of the position from the point of view of the side to move.
     Value evaluate(Position const &pos) {
         assert(pos.checkers() == 0);
@@ -1144,7 +1119,7 @@ namespace Evaluator {
             // If there is PSQ imbalance use classical eval, with small probability if it is small
             Value   const psq{ Value(std::abs(egValue(pos.psqScore()))) };
             int32_t const r50{ 16 + pos.clockPly() };
-            bool    const psqLarge{ psq * 16 > (NNUEThreshold1 + npm / 64) * r50 };
+            bool    const psqLarge{ imbalanced(pos) };
             bool    const classical{
                 psqLarge
              || ( psq > VALUE_MG_PAWN / 4
@@ -20,14 +20,20 @@ namespace Evaluator {
 
         extern bool loadEvalFile(std::istream&);
 
+        extern std::string architecture();
+
         extern Value evaluate(Position const&);
 
+        extern void updateAccumulators(Position const&);
+
         extern void initialize();
 
         extern void verify();
 
     }
 
+    extern bool imbalanced(Position const&);
+
     extern Value evaluate(Position const&);
 
     extern std::string trace(Position const&);
@@ -0,0 +1,41 @@
+#include "arena.h"
+
+#if defined(ALLOC_COUNT)
+    #include <cstdlib>
+#endif
+
+thread_local Arena *Arena::Current{ nullptr };
+
+#if defined(ALLOC_COUNT)
+
+/// Allocation-count mode: the global allocator is replaced so as to count in the arena
+/// of the running thread (i.e. while searching) every allocation that reaches the global heap.
+
+void* operator new(size_t size) {
+    if (Arena::Current != nullptr) {
+        ++Arena::Current->heapAllocs;
+    }
+    void *p{ std::malloc(size != 0 ? size : 1) };
+    if (p == nullptr) {
+        std::abort();
+    }
+    return p;
+}
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+#endif
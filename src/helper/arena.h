@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+/// Arena is a per-thread bump allocator for the node-scoped containers of the search
+/// (generated moves, searched quiets and captures), so that no node goes through the
+/// global allocator, which is contended with many threads.
+/// Memory is taken by bumping the top and given back only by an enclosing Scope
+/// (one per search node) or by reset() (at each new search), deallocation is a no-op.
+/// When the arena is full the allocations fall back to the global heap.
+class Arena final {
+
+public:
+
+    static constexpr size_t Alignment{ 16 };
+
+    explicit Arena(size_t cap) :
+        buffer{ new char[cap] },
+        capacity{ cap } {
+    }
+
+    Arena() = delete;
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    void* allocate(size_t size) noexcept {
+        size = (size + Alignment - 1) & ~(Alignment - 1);
+        if (top + size > capacity) {
+            ++overflows;
+            return nullptr;
+        }
+        void *p{ buffer.get() + top };
+        top += size;
+        if (peak < top) {
+            peak = top;
+        }
+        return p;
+    }
+
+    bool owns(void const *p) const noexcept {
+        return buffer.get() <= static_cast<char const*>(p)
+            && static_cast<char const*>(p) < buffer.get() + capacity;
+    }
+
+    void reset() noexcept {
+        top = 0;
+    }
+
+    /// Scope gives back on exit all that the current arena (if any) allocated in its lifetime
+    class Scope final {
+
+    public:
+
+        Scope() noexcept :
+            arena{ Current },
+            mark{ arena != nullptr ? arena->top : 0 } {
+        }
+        ~Scope() noexcept {
+            if (arena != nullptr) {
+                arena->top = mark;
+            }
+        }
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+    private:
+
+        Arena *arena;
+        size_t mark;
+    };
+
+    // Arena of the running thread, nullptr for the threads without one
+    static thread_local Arena *Current;
+
+    size_t   peak{ 0 };
+    uint64_t overflows{ 0 };
+    uint64_t heapAllocs{ 0 }; // Counted only with ALLOC_COUNT
+
+private:
+
+    std::unique_ptr<char[]> buffer;
+    size_t capacity;
+    size_t top{ 0 };
+};
+
+/// ArenaAllocator is the standard allocator drawing from the arena of the running thread,
+/// or from the global heap when there is none (or it is full).
+/// Containers using it must not outlive the Scope they were filled in.
+template<typename T>
+class ArenaAllocator {
+
+public:
+
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template<typename U>
+    ArenaAllocator(ArenaAllocator<U> const&) noexcept {}
+
+    T* allocate(size_t n) {
+        auto *arena{ Arena::Current };
+        if (arena != nullptr) {
+            void *p{ arena->allocate(n * sizeof(T)) };
+            if (p != nullptr) {
+                return static_cast<T*>(p);
+            }
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t) noexcept {
+        auto *arena{ Arena::Current };
+        if (arena != nullptr
+         && arena->owns(p)) {
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    template<typename U>
+    bool operator==(ArenaAllocator<U> const&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(ArenaAllocator<U> const&) const noexcept { return false; }
+};
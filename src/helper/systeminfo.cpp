@@ -0,0 +1,239 @@
+#include "systeminfo.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    // Disable macros min() and max()
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+    #endif
+    // Excludes APIs such as Cryptography, DDE, RPC, Socket
+    #if !defined(WIN32_LEAN_AND_MEAN)
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+
+    #include <Windows.h>
+
+    #undef NOMINMAX
+    #undef WIN32_LEAN_AND_MEAN
+#else
+    #include <unistd.h>
+    #include <sys/resource.h>
+    #if defined(__linux__)
+        #include <sched.h>
+    #endif
+#endif
+
+namespace SystemInfo {
+
+    uint16_t hardwareCount{ 1 };
+    uint16_t affinityCount{ 1 };
+    uint16_t quotaCount{ 0 };
+    size_t   physicalMemory{ 0 };
+    size_t   limitMemory{ 0 };
+
+    namespace {
+
+    #if defined(__linux__) && !defined(__ANDROID__)
+
+        /// readLine() reads the first line of a (pseudo) file, empty if not readable.
+        std::string readLine(std::string const &filename) {
+            std::string line;
+            std::ifstream ifstream{ filename, std::ios::in };
+            if (ifstream.is_open()) {
+                std::getline(ifstream, line);
+                ifstream.close();
+            }
+            return line;
+        }
+
+        /// cgroupDirs() returns the candidate directories of the cgroup of the process
+        /// for the given v1 controller ("" for the v2 unified hierarchy).
+        /// Inside a container the cgroup is usually mounted as the root, so fall back to it.
+        std::vector<std::string> cgroupDirs(std::string const &controller) {
+            std::string const mount{ controller.empty() ? "/sys/fs/cgroup" : "/sys/fs/cgroup/" + controller };
+
+            std::vector<std::string> dirs;
+            // Each line is "hierarchy-ID:controller-list:cgroup-path"
+            std::ifstream ifstream{ "/proc/self/cgroup", std::ios::in };
+            std::string line;
+            while (std::getline(ifstream, line)) {
+                auto const pos1{ line.find(':') };
+                auto const pos2{ line.find(':', pos1 + 1) };
+                if (pos1 == std::string::npos
+                 || pos2 == std::string::npos) {
+                    continue;
+                }
+                std::string const controllers{ line.substr(pos1 + 1, pos2 - pos1 - 1) };
+                std::string const path{ line.substr(pos2 + 1) };
+                if (controller.empty() ?
+                        controllers.empty() :
+                        ("," + controllers + ",").find("," + controller + ",") != std::string::npos) {
+                    if (path != "/") {
+                        dirs.push_back(mount + path);
+                    }
+                }
+            }
+            dirs.push_back(mount);
+            return dirs;
+        }
+
+        uint16_t cgroupQuotaCount() {
+            // cgroup v2: "cpu.max" contains "<quota|max> <period>"
+            for (auto const &dir : cgroupDirs("")) {
+                auto const line{ readLine(dir + "/cpu.max") };
+                if (line.empty()) {
+                    continue;
+                }
+                if (line.find("max") == 0) {
+                    return 0;
+                }
+                double quota{ 0 }, period{ 0 };
+                if (std::sscanf(line.c_str(), "%lf %lf", &quota, &period) == 2
+                 && quota > 0 && period > 0) {
+                    return uint16_t(std::max(std::ceil(quota / period), 1.0));
+                }
+            }
+            // cgroup v1: "cpu.cfs_quota_us" is -1 when there is no quota
+            for (auto const &controller : { "cpu", "cpu,cpuacct" }) {
+                for (auto const &dir : cgroupDirs(controller)) {
+                    auto const quotaLine{ readLine(dir + "/cpu.cfs_quota_us") };
+                    auto const periodLine{ readLine(dir + "/cpu.cfs_period_us") };
+                    if (quotaLine.empty()
+                     || periodLine.empty()) {
+                        continue;
+                    }
+                    double const quota{ std::atof(quotaLine.c_str()) };
+                    double const period{ std::atof(periodLine.c_str()) };
+                    return quota > 0 && period > 0 ?
+                            uint16_t(std::max(std::ceil(quota / period), 1.0)) : 0;
+                }
+            }
+            return 0;
+        }
+
+        size_t cgroupLimitMemory() {
+            // cgroup v2: "memory.max" contains "max" or the limit in bytes
+            for (auto const &dir : cgroupDirs("")) {
+                auto const line{ readLine(dir + "/memory.max") };
+                if (line.empty()) {
+                    continue;
+                }
+                return line.find("max") == 0 ? 0 : size_t(std::strtoull(line.c_str(), nullptr, 10));
+            }
+            // cgroup v1: "memory.limit_in_bytes" is a huge number when there is no limit
+            for (auto const &dir : cgroupDirs("memory")) {
+                auto const line{ readLine(dir + "/memory.limit_in_bytes") };
+                if (line.empty()) {
+                    continue;
+                }
+                return size_t(std::strtoull(line.c_str(), nullptr, 10));
+            }
+            return 0;
+        }
+
+    #endif
+    }
+
+    /// SystemInfo::initialize() detects the processors and the memory available to the process.
+    void initialize() noexcept {
+
+        hardwareCount = uint16_t(std::max(std::thread::hardware_concurrency(), 1U));
+        affinityCount = hardwareCount;
+        quotaCount = 0;
+        physicalMemory = 0;
+        limitMemory = 0;
+
+    #if defined(_WIN32)
+
+        // Affinity mask covers only the current processor group
+        DWORD_PTR processMask, systemMask;
+        if (hardwareCount <= 64
+         && GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            uint16_t count{ 0 };
+            for (; processMask != 0; processMask &= processMask - 1) {
+                ++count;
+            }
+            affinityCount = std::max(count, uint16_t(1));
+        }
+
+        MEMORYSTATUSEX memStatus;
+        memStatus.dwLength = sizeof(memStatus);
+        if (GlobalMemoryStatusEx(&memStatus)) {
+            physicalMemory = size_t(memStatus.ullTotalPhys);
+        }
+
+    #else
+
+        #if defined(__linux__) && !defined(__ANDROID__)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+            affinityCount = uint16_t(std::max(CPU_COUNT(&cpuSet), 1));
+        }
+
+        quotaCount = cgroupQuotaCount();
+        limitMemory = cgroupLimitMemory();
+        #endif
+
+        #if defined(_SC_PHYS_PAGES) && defined(_SC_PAGE_SIZE)
+        long const pages{ sysconf(_SC_PHYS_PAGES) };
+        long const pageSize{ sysconf(_SC_PAGE_SIZE) };
+        if (pages > 0
+         && pageSize > 0) {
+            physicalMemory = size_t(pages) * size_t(pageSize);
+        }
+        #endif
+
+    #endif
+
+        // cgroup v1 reports "no limit" as a huge number
+        if (physicalMemory != 0
+         && limitMemory >= physicalMemory) {
+            limitMemory = 0;
+        }
+    }
+
+    /// SystemInfo::cpuCount() returns the effective number of processors usable by the process.
+    uint16_t cpuCount() noexcept {
+        auto count{ std::min(hardwareCount, affinityCount) };
+        if (quotaCount != 0) {
+            count = std::min(count, quotaCount);
+        }
+        return std::max(count, uint16_t(1));
+    }
+
+    /// SystemInfo::memoryLimit() returns the effective memory in bytes usable by the process (0 if unknown).
+    size_t memoryLimit() noexcept {
+        return limitMemory != 0 ? limitMemory : physicalMemory;
+    }
+
+    /// SystemInfo::cpuTime() returns the CPU time (user + system) in seconds used by the process so far.
+    double cpuTime() noexcept {
+    #if defined(_WIN32)
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+        if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+            return 0.0;
+        }
+        auto const toTicks = [](FILETIME const &ft) {
+            return (uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+        };
+        // FILETIME is in 100 nano-seconds units
+        return (toTicks(kernelTime) + toTicks(userTime)) * 1e-7;
+    #else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0.0;
+        }
+        return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+             + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    #endif
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// SystemInfo detects the resources the process is really allowed to use.
+/// std::thread::hardware_concurrency() and the physical memory ignore the
+/// CPU affinity mask and the cgroup (container) CPU quota and memory limit,
+/// so relying on them oversubscribes CPUs and risks OOM-kills in containers.
+namespace SystemInfo {
+
+    extern uint16_t hardwareCount;  // logical processors of the machine
+    extern uint16_t affinityCount;  // logical processors in the affinity mask
+    extern uint16_t quotaCount;     // processors allowed by cgroup cpu quota (0 if no quota)
+    extern size_t   physicalMemory; // physical memory in bytes (0 if unknown)
+    extern size_t   limitMemory;    // cgroup memory limit in bytes (0 if no limit)
+
+    extern void initialize() noexcept;
+
+    extern uint16_t cpuCount() noexcept;
+    extern size_t memoryLimit() noexcept;
+
+    extern double cpuTime() noexcept;
+}
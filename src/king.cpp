@@ -4,6 +4,7 @@
 #include <algorithm>
 
 #include "bitboard.h"
+#include "evalparam.h"
 #include "thread.h"
 #include "zobrist.h"
 
@@ -12,36 +13,6 @@ namespace King {
     namespace {
 
     #define S(mg, eg) makeScore(mg, eg)
-        // Safety of friend pawns shelter for our king by [distance from edge][rank].
-        // RANK_1 is used for files where we have no pawn, or pawn is behind our king.
-        constexpr Score Shelter[FILES/2][RANKS]{
-            { S( -5, 0), S( 82, 0), S( 92, 0), S( 54, 0), S( 36, 0), S( 22, 0), S(  28, 0), S(0, 0) },
-            { S(-44, 0), S( 63, 0), S( 33, 0), S(-50, 0), S(-30, 0), S(-12, 0), S( -62, 0), S(0, 0) },
-            { S(-11, 0), S( 77, 0), S( 22, 0), S( -6, 0), S( 31, 0), S(  8, 0), S( -45, 0), S(0, 0) },
-            { S(-39, 0), S(-12, 0), S(-29, 0), S(-50, 0), S(-43, 0), S(-68, 0), S(-164, 0), S(0, 0) }
-        };
-
-        // Danger of unblocked enemy pawns storm toward our king by [distance from edge][rank].
-        // RANK_1 is used for files where the enemy has no pawn, or their pawn is behind our king.
-        // [0][1 - 2] accommodate opponent pawn on edge (likely blocked by king)
-        constexpr Score UnblockedStorm[FILES/2][RANKS]{
-            { S( 87, 0), S(-288, 0), S(-168, 0), S( 96, 0), S( 47, 0), S( 44, 0), S( 46, 0), S(0, 0) },
-            { S( 42, 0), S( -25, 0), S( 120, 0), S( 45, 0), S( 34, 0), S( -9, 0), S( 24, 0), S(0, 0) },
-            { S( -8, 0), S(  51, 0), S( 167, 0), S( 35, 0), S( -4, 0), S(-16, 0), S(-12, 0), S(0, 0) },
-            { S(-17, 0), S( -13, 0), S( 100, 0), S(  4, 0), S(  9, 0), S(-16, 0), S(-31, 0), S(0, 0) }
-        };
-
-        constexpr Score BlockedStorm[RANKS]{
-            S( 0, 0), S( 0, 0), S( 76, 78), S(-10, 15), S(-7, 10), S(-4, 6), S(-1, 2), S( 0, 0)
-        };
-
-        // KingOnFile[semi-open Us][semi-open Them] contains bonuses/penalties
-        // for king when the king is on a semi-open or open file.
-        constexpr Score KingOnFile[2][2]{
-            { S(-19, 12), S(-6,  7) },
-            { S(  0,  2), S( 6, -5) }
-        };
-
         constexpr Score BasicShelter { S( 5, 5) };
 
     #undef S
@@ -71,15 +42,15 @@ namespace King {
 
             auto const d{ edgeDistance(f) };
             bonus +=
-                Shelter[d][ownR]
+                EvalParams.Shelter[d][ownR]
               - (ownR != RANK_1
               && ownR == oppR - 1 ?
-                    BlockedStorm[oppR] :
-                    UnblockedStorm[d][oppR]);
+                    EvalParams.BlockedStorm[oppR] :
+                    EvalParams.UnblockedStorm[d][oppR]);
         }
 
         // King On File
-        bonus -= KingOnFile[pos.semiopenFileOn(Own, kSq)][pos.semiopenFileOn(Opp, kSq)];
+        bonus -= EvalParams.KingOnFile[pos.semiopenFileOn(Own, kSq)][pos.semiopenFileOn(Opp, kSq)];
 
         return bonus;
     }
@@ -14,11 +14,19 @@
 #include "uci.h"
 #include "zobrist.h"
 #include "helper/commandline.h"
+#include "helper/systeminfo.h"
 
 int main(int argc, char const *const argv[]) {
 
     std::cout << Name << " " << engineInfo() << " by " << Author << '\n';
-    std::cout << "info string Processor(s) detected " << std::thread::hardware_concurrency() << '\n';
+    SystemInfo::initialize();
+    std::cout << "info string Processor(s) detected " << SystemInfo::hardwareCount
+              << " (affinity " << SystemInfo::affinityCount
+              << ", quota " << SystemInfo::quotaCount
+              << ") usable " << SystemInfo::cpuCount() << '\n';
+    std::cout << "info string Memory detected " << (SystemInfo::physicalMemory >> 20) << " MB"
+              << " (limit " << (SystemInfo::limitMemory >> 20) << " MB)"
+              << " usable " << (SystemInfo::memoryLimit() >> 20) << " MB" << '\n';
 
     // path+name of the executable binary, as given by argv[0]
     CommandLine::initialize(argv[0]);
@@ -1,5 +1,12 @@
 #include "movepicker.h"
 
+#if defined(USE_AVX2)
+    #include <cstddef>
+    #include <immintrin.h>
+#endif
+
+#include "thread.h"
+
 namespace {
 
     enum Stage : uint8_t {
@@ -29,19 +36,43 @@ namespace {
     /// partialSort() sorts (insertion) item in descending order up to and including a given limit.
     /// The order of item smaller than the limit is left unspecified.
     /// Sorts only in range [beg, end]
+    /// With AVX2 the values are compared to the limit 8 at a time and only the items reaching it
+    /// are inserted, the insertions write only behind the current item so the result is the same.
     void partialSort(ValMoves::iterator beg, ValMoves::iterator end, int32_t limit) {
 
         auto sortedEnd{ beg };
-        for (auto unsortedBeg{ sortedEnd + 1 }; unsortedBeg < end; ++unsortedBeg) {
+        auto insert{ [&](ValMoves::iterator unsortedBeg) {
+            auto unsortedItem{ *unsortedBeg };
+            *unsortedBeg = *++sortedEnd;
+
+            auto itr{ sortedEnd };
+            for (; itr != beg && *(itr-1) < unsortedItem; --itr) {
+                *itr = *(itr-1);
+            }
+            *itr = unsortedItem;
+        } };
+
+        auto unsortedBeg{ sortedEnd + 1 };
+    #if defined(USE_AVX2)
+        static_assert(sizeof(ValMove) == 8
+                   && offsetof(ValMove, value) == 4, "ValMove value is the odd 32-bit word");
+
+        __m256i const limits{ _mm256_set1_epi32(limit - 1) };
+        for (; unsortedBeg + 8 <= end; unsortedBeg += 8) {
+            auto const *p{ reinterpret_cast<__m256i const*>(&*unsortedBeg) };
+            uint32_t mask{
+                uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_loadu_si256(p + 0), limits))))
+             | (uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_loadu_si256(p + 1), limits)))) << 8) };
+            mask &= 0xAAAA;
+            while (mask != 0) {
+                insert(unsortedBeg + (scanLSq(mask) >> 1));
+                mask &= mask - 1;
+            }
+        }
+    #endif
+        for (; unsortedBeg < end; ++unsortedBeg) {
             if (unsortedBeg->value >= limit) {
-                auto unsortedItem{ *unsortedBeg };
-                *unsortedBeg = *++sortedEnd;
-
-                auto itr{ sortedEnd };
-                for (; itr != beg && *(itr-1) < unsortedItem; --itr) {
-                    *itr = *(itr-1);
-                }
-                *itr = unsortedItem;
+                insert(unsortedBeg);
             }
         }
     }
@@ -152,6 +183,13 @@ void MovePicker::value() {
                 || GT == QUIET
                 || GT == EVASION, "GT incorrect");
 
+#if defined(USE_AVX2) && defined(USE_GATHER)
+    if constexpr (GT == QUIET) {
+        valueQuiets();
+        return;
+    }
+#endif
+
     for (auto vm{ vmBeg }; vm < vmEnd; ++vm) {
 
         switch (GT) {
@@ -185,6 +223,63 @@ void MovePicker::value() {
     }
 }
 
+#if defined(USE_AVX2) && defined(USE_GATHER)
+
+namespace {
+
+    /// gatherStats() gathers 8 int16_t history entries of the table at the indices.
+    /// The 32-bit words read also cover the next entry, it is never past the end of
+    /// the tables for real moves (the last entry is of a null move or of no piece).
+    inline __m256i gatherStats(void const *table, __m256i indices) noexcept {
+        __m256i const words{ _mm256_i32gather_epi32(static_cast<int const*>(table), indices, 2) };
+        return _mm256_srai_epi32(_mm256_slli_epi32(words, 16), 16);
+    }
+}
+
+/// valueQuiets() is value<QUIET>() for AVX2: the table indices of the moves are computed
+/// in batches of 8 (structure of arrays), then the history terms are gathered and summed in vectors.
+void MovePicker::valueQuiets() noexcept {
+
+    auto const *bfStats{ (*butterFlyStats)[pos.activeSide()].data() };
+    auto const *lpStats{ ply < MAX_LOWPLY ? (*lowPlyStats)[ply].data() : nullptr };
+    __m256i const lpFactor{ _mm256_set1_epi32(std::min(depth / 3, 4)) };
+
+    alignas(32) int32_t masks[8];
+    alignas(32) int32_t pieceDsts[8];
+    alignas(32) int32_t values[8];
+
+    for (auto vm{ vmBeg }; vm < vmEnd; vm += 8) {
+        auto const count{ std::min(vmEnd - vm, ValMoves::difference_type(8)) };
+
+        for (int32_t i = 0; i < 8; ++i) {
+            // Pad with index 0, its values are ignored
+            Move const m{ i < count ? vm[i].move : MOVE_NONE };
+            masks[i] = mMask(m);
+            pieceDsts[i] = pos.movedPiece(m) * SQUARES + dstSq(m);
+        }
+        __m256i const maskIdx{ _mm256_load_si256(reinterpret_cast<__m256i const*>(masks)) };
+        __m256i const pieceDstIdx{ _mm256_load_si256(reinterpret_cast<__m256i const*>(pieceDsts)) };
+
+        __m256i contSum{ gatherStats(contStats[0]->data(), pieceDstIdx) };
+        contSum = _mm256_add_epi32(contSum, gatherStats(contStats[1]->data(), pieceDstIdx));
+        contSum = _mm256_add_epi32(contSum, gatherStats(contStats[3]->data(), pieceDstIdx));
+
+        __m256i sum{ gatherStats(bfStats, maskIdx) };
+        sum = _mm256_add_epi32(sum, _mm256_slli_epi32(contSum, 1));
+        sum = _mm256_add_epi32(sum, gatherStats(contStats[5]->data(), pieceDstIdx));
+        if (lpStats != nullptr) {
+            sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(gatherStats(lpStats, maskIdx), lpFactor));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), sum);
+
+        for (int32_t i = 0; i < count; ++i) {
+            vm[i].value = values[i];
+        }
+    }
+}
+
+#endif
+
 /// pick() returns the next move satisfying a predicate function
 template<typename Pred>
 bool MovePicker::pick(Pred filter) {
@@ -287,8 +382,18 @@ Move MovePicker::nextMove() {
                                         return vm == ttMove
                                             || std::find(mBeg, mEnd, vm) != mEnd; // refutationMoves.contains(vm)
                                     });
-            value<QUIET>();
-            partialSort(vmBeg, vmEnd, -3000 * depth);
+            if (!Threadpool.nodeTiming) {
+                value<QUIET>();
+                partialSort(vmBeg, vmEnd, -3000 * depth);
+            } else {
+                auto &timing{ pos.thread()->timing };
+                auto const startTime{ nowNS() };
+                value<QUIET>();
+                auto const valueTime{ nowNS() };
+                partialSort(vmBeg, vmEnd, -3000 * depth);
+                timing.quietValueTime += valueTime - startTime;
+                timing.sortTime += nowNS() - valueTime;
+            }
         }
         ++stage;
     }
@@ -379,3 +484,20 @@ Move MovePicker::nextMove() {
         return MOVE_NONE;
     }
 }
+
+/// pickStage() returns the stage of the move returned last by nextMove()
+PickStage MovePicker::pickStage() const noexcept {
+    switch (stage) {
+    // Stage is already advanced past the ttMove
+    case NORMAL_INIT:
+    case EVASION_INIT:
+    case PROBCUT_INIT:
+    case QUIESCENCE_INIT:      return PICK_TT;
+    case NORMAL_GOOD_CAPTURES: return PICK_GOOD_CAPTURE;
+    case NORMAL_REFUTATIONS:   return PICK_REFUTATION;
+    case NORMAL_QUIETS:        return PICK_QUIET;
+    case NORMAL_BAD_CAPTURES:  return PICK_BAD_CAPTURE;
+    case EVASION_MOVES:        return PICK_EVASION;
+    default:                   return PICK_OTHER;
+    }
+}
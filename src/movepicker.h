@@ -122,6 +122,18 @@ using ContinuationStatsTable    = Table<PieceSquareStatsTable, PIECES, SQUARES>;
 using PieceSquareMoveTable      = Table<Move, PIECES, SQUARES>;
 
 
+/// PickStage is the stage of the move picked last, for the move ordering statistics
+enum PickStage : uint8_t {
+    PICK_TT,
+    PICK_GOOD_CAPTURE,
+    PICK_REFUTATION,
+    PICK_QUIET,
+    PICK_BAD_CAPTURE,
+    PICK_EVASION,
+    PICK_OTHER,
+    PICK_STAGES = 7
+};
+
 /// MovePicker class is used to pick one legal moves from the current position.
 /// nextMove() is the most important method, which returns a new legal move every time until there are no more moves
 /// In order to improve the efficiency of the alpha-beta algorithm,
@@ -160,6 +172,7 @@ public:
     MovePicker& operator=(MovePicker&&) = delete;
 
     Move nextMove();
+    PickStage pickStage() const noexcept;
 
     bool pickQuiets;
 
@@ -167,6 +180,9 @@ private:
 
     template<GenType GT>
     void value();
+#if defined(USE_AVX2) && defined(USE_GATHER)
+    void valueQuiets() noexcept;
+#endif
 
     template<typename Pred>
     bool pick(Pred);
@@ -191,8 +207,8 @@ private:
     ValMoves::iterator vmBeg,
                        vmEnd;
 
-    Moves refutationMoves,
-          badCaptureMoves;
-    Moves::iterator mBeg,
-                    mEnd;
+    NodeMoves refutationMoves,
+              badCaptureMoves;
+    NodeMoves::iterator mBeg,
+                        mEnd;
 };
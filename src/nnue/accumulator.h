@@ -11,7 +11,7 @@ namespace Evaluator::NNUE {
     // Class that holds the result of affine transformation of input features
     struct alignas(CacheLineSize) Accumulator {
 
-        int16_t accumulation[COLORS][RefreshTriggers.size()][TransformedFeatureDimensions];
+        int16_t accumulation[COLORS][RefreshTriggers.size()][MaxTransformedFeatureDimensions];
 
         AccumulatorState state[COLORS];
     };
@@ -1,6 +1,8 @@
 #pragma once
 // Input features and network structure used in NNUE evaluation function
 
+#include <algorithm>
+
 #include "../type.h"
 // Defines the network structure
 #include "architectures/HalfKP_256x2-32-32.h"
@@ -11,6 +13,25 @@ namespace Evaluator::NNUE {
     static_assert(Network::OutputDimensions == 1, "");
     static_assert(std::is_same<Network::OutputType, int32_t>::value, "");
 
+    // Transformed feature dimensions of the architectures a network file may have,
+    // the first one is the default. The others are only built with NNUE_ARCHS.
+    template<IndexType... Dimensions>
+    struct ArchitectureList {
+        static_assert(((Dimensions % MaxSimdWidth == 0) && ...), "");
+
+        static constexpr size_t Count{ sizeof...(Dimensions) };
+        static constexpr IndexType MaxDimensions{ std::max({ Dimensions... }) };
+    };
+
+#if defined(NNUE_ARCHS)
+    using Architectures = ArchitectureList<TransformedFeatureDimensions, 128, 512, 1024>;
+#else
+    using Architectures = ArchitectureList<TransformedFeatureDimensions>;
+#endif
+
+    // Accumulator size, enough for all the architectures
+    constexpr IndexType MaxTransformedFeatureDimensions{ Architectures::MaxDimensions };
+
     // Trigger for full calculation instead of difference calculation
     constexpr auto RefreshTriggers{ RawFeatures::RefreshTriggers };
 
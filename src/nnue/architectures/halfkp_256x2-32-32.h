@@ -18,14 +18,20 @@ namespace Evaluator::NNUE {
 
     namespace Layers {
 
-        // Define network structure
-        using InputLayer = InputSlice<TransformedFeatureDimensions * 2>;
-        using HiddenLayer1 = ClippedReLU<AffineTransform<InputLayer, 32>>;
-        using HiddenLayer2 = ClippedReLU<AffineTransform<HiddenLayer1, 32>>;
-        using OutputLayer = AffineTransform<HiddenLayer2, 1>;
+        // Define network structure for the given number of transformed feature dimensions
+        template<IndexType TransformedDimensions>
+        struct HalfKPNetwork {
+            using InputLayer = InputSlice<TransformedDimensions * 2>;
+            using HiddenLayer1 = ClippedReLU<AffineTransform<InputLayer, 32>>;
+            using HiddenLayer2 = ClippedReLU<AffineTransform<HiddenLayer1, 32>>;
+            using OutputLayer = AffineTransform<HiddenLayer2, 1>;
+        };
 
     }
 
-    using Network = Layers::OutputLayer;
+    template<IndexType TransformedDimensions>
+    using NetworkOf = typename Layers::HalfKPNetwork<TransformedDimensions>::OutputLayer;
+
+    using Network = NetworkOf<TransformedFeatureDimensions>;
 
 }
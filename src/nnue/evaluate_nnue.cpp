@@ -56,17 +56,66 @@ namespace Evaluator::NNUE {
     }
 
     namespace {
-        // Input feature converter
-        AlignedLargePagePtr<FeatureTransformer> featureTransformer;
 
-        // Evaluation function
-        AlignedStdPtr<Network> network;
+        /// Net holds the parameters of the network with the given transformed feature dimensions
+        template<IndexType Dimensions>
+        struct Net {
 
-        /// Initialize the evaluation function parameters
-        void initializeParameters() {
-            alignedLargePageAllocator(featureTransformer);
-            alignedStdAllocator(network);
-        }
+            // Input feature converter
+            static inline AlignedLargePagePtr<FeatureTransformer<Dimensions>> featureTransformer;
+
+            // Evaluation function
+            static inline AlignedStdPtr<NetworkOf<Dimensions>> network;
+
+            /// Initialize the evaluation function parameters
+            static void initializeParameters() {
+                alignedLargePageAllocator(featureTransformer);
+                alignedStdAllocator(network);
+            }
+
+            /// Release the evaluation function parameters
+            static void release() {
+                featureTransformer.reset();
+                network.reset();
+            }
+
+            // Evaluation function. Perform differential calculation.
+            static Value evaluate(Position const &pos) {
+                // We manually align the arrays on the stack because with gcc < 9.3
+                // overaligning stack variables with alignas() doesn't work correctly.
+
+                constexpr uint64_t alignment = CacheLineSize;
+
+        #if defined(ALIGNAS_ON_STACK_VARIABLES_BROKEN)
+                TransformedFeatureType transformedFeaturesUnaligned[FeatureTransformer<Dimensions>::BufferSize + alignment / sizeof(TransformedFeatureType)];
+                char bufferUnaligned[NetworkOf<Dimensions>::BufferSize + alignment];
+
+                auto *transformedFeatures{ alignUpPtr<alignment>(&transformedFeaturesUnaligned[0]) };
+                auto *buffer{ alignUpPtr<alignment>(&bufferUnaligned[0]) };
+        #else
+                alignas(alignment) TransformedFeatureType transformedFeatures[FeatureTransformer<Dimensions>::BufferSize];
+                alignas(alignment) char buffer[NetworkOf<Dimensions>::BufferSize];
+        #endif
+
+                ASSERT_ALIGNED(transformedFeatures, alignment);
+                ASSERT_ALIGNED(buffer, alignment);
+
+                featureTransformer->transform(pos, transformedFeatures);
+                auto const output{ network->propagate(transformedFeatures, buffer) };
+
+                return static_cast<Value>(output[0] / FVScale);
+            }
+
+            // Update the accumulators ahead of the evaluation
+            static void updateAccumulators(Position const &pos) {
+                featureTransformer->updateAccumulators(pos);
+            }
+        };
+
+        // Net of the loaded network file, dispatched through pointers only with several architectures
+        IndexType loadedDimensions{ TransformedFeatureDimensions };
+        Value   (*evaluateNet)(Position const&){ Net<TransformedFeatureDimensions>::evaluate };
+        void    (*updateNet)(Position const&){ Net<TransformedFeatureDimensions>::updateAccumulators };
 
         /// Read network header
         bool readHeader(std::istream &istream, uint32_t *hashValue, std::string *architecture) {
@@ -93,52 +142,68 @@ namespace Evaluator::NNUE {
                 reference.readParameters(istream);
         }
 
+        /// Read the network parameters of the given architecture, and make it the loaded one
+        template<IndexType Dimensions>
+        bool readNet(std::istream &istream) {
+            Net<Dimensions>::initializeParameters();
+            if (!readParameters(istream, *Net<Dimensions>::featureTransformer)
+             || !readParameters(istream, *Net<Dimensions>::network)
+             || !istream
+             || istream.peek() != std::ios::traits_type::eof()) {
+                return false;
+            }
+            loadedDimensions = Dimensions;
+            evaluateNet = Net<Dimensions>::evaluate;
+            updateNet = Net<Dimensions>::updateAccumulators;
+            return true;
+        }
+
+        /// Read the network parameters of the architecture whose hash value is in the header,
+        /// then release the parameters of the other architectures
+        template<IndexType... Dimensions>
+        bool readNet(std::istream &istream, uint32_t hashValue, ArchitectureList<Dimensions...>) {
+            if (!((hashValue == HashValueOf<Dimensions> && readNet<Dimensions>(istream)) || ...)) {
+                return false;
+            }
+            ((Dimensions != loadedDimensions ? Net<Dimensions>::release() : void()), ...);
+            return true;
+        }
+
         // Read network parameters
         bool readParameters(std::istream &istream) {
             uint32_t hashValue;
             std::string architecture;
-            if (!readHeader(istream, &hashValue, &architecture)
-             || hashValue != HashValue
-             || !readParameters(istream, *featureTransformer)
-             || !readParameters(istream, *network)) {
-                return false;
-            }
-            return istream
-                && istream.peek() == std::ios::traits_type::eof();
+            return readHeader(istream, &hashValue, &architecture)
+                && readNet(istream, hashValue, Architectures{});
         }
     }
 
     // Load the evaluation function file
     bool loadEvalFile(std::istream &istream) {
-        initializeParameters();
         return readParameters(istream);
     }
 
-    // Evaluation function. Perform differential calculation.
-    Value evaluate(Position const &pos) {
-        // We manually align the arrays on the stack because with gcc < 9.3
-        // overaligning stack variables with alignas() doesn't work correctly.
-
-        constexpr uint64_t alignment = CacheLineSize;
-
-#if defined(ALIGNAS_ON_STACK_VARIABLES_BROKEN)
-        TransformedFeatureType transformedFeaturesUnaligned[FeatureTransformer::BufferSize + alignment / sizeof(TransformedFeatureType)];
-        char bufferUnaligned[Network::BufferSize + alignment];
-
-        auto *transformedFeatures{ alignUpPtr<alignment>(&transformedFeaturesUnaligned[0]) };
-        auto *buffer{ alignUpPtr<alignment>(&bufferUnaligned[0]) };
-#else
-        alignas(alignment) TransformedFeatureType transformedFeatures[FeatureTransformer::BufferSize];
-        alignas(alignment) char buffer[Network::BufferSize];
-#endif
-
-        ASSERT_ALIGNED(transformedFeatures, alignment);
-        ASSERT_ALIGNED(buffer, alignment);
+    // Architecture of the loaded network
+    std::string architecture() {
+        return "HalfKP " + std::to_string(loadedDimensions) + "x2-32-32";
+    }
 
-        featureTransformer->transform(pos, transformedFeatures);
-        auto const output{ network->propagate(transformedFeatures, buffer) };
+    // Evaluation function
+    Value evaluate(Position const &pos) {
+        if constexpr (Architectures::Count == 1) {
+            return Net<TransformedFeatureDimensions>::evaluate(pos);
+        } else {
+            return evaluateNet(pos);
+        }
+    }
 
-        return static_cast<Value>(output[0] / FVScale);
+    // Update the accumulators ahead of the evaluation
+    void updateAccumulators(Position const &pos) {
+        if constexpr (Architectures::Count == 1) {
+            Net<TransformedFeatureDimensions>::updateAccumulators(pos);
+        } else {
+            updateNet(pos);
+        }
     }
 
 }
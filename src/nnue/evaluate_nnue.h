@@ -8,7 +8,10 @@
 namespace Evaluator::NNUE {
 
     // Hash value of evaluation function structure
-    constexpr uint32_t HashValue{ FeatureTransformer::getHashValue() ^ Network::getHashValue() };
+    template<IndexType TransformedDimensions>
+    constexpr uint32_t HashValueOf{ FeatureTransformer<TransformedDimensions>::getHashValue() ^ NetworkOf<TransformedDimensions>::getHashValue() };
+
+    constexpr uint32_t HashValue{ HashValueOf<TransformedFeatureDimensions> };
 
     // Deleter for automating release of memory area
     template<typename T>
@@ -62,15 +62,18 @@ namespace Evaluator::NNUE {
 
     #endif
 
-    // Input feature converter
+    // Input feature converter with the given number of output dimensions for one side
+    template<IndexType TransformedDimensions>
     class FeatureTransformer {
 
     private:
         // Number of output dimensions for one side
-        static constexpr IndexType HalfDimensions{ TransformedFeatureDimensions };
+        static constexpr IndexType HalfDimensions{ TransformedDimensions };
 
     #if defined(VECTOR)
-        static constexpr IndexType TileHeight = NumRegs * sizeof(vec_t) / 2;
+        // Registers per tile, fewer than NumRegs for the narrow architectures
+        static constexpr IndexType TileRegs = std::min<IndexType>(NumRegs, HalfDimensions * 2 / sizeof(vec_t));
+        static constexpr IndexType TileHeight = TileRegs * sizeof(vec_t) / 2;
         static_assert(HalfDimensions % TileHeight == 0, "TileHeight must divide HalfDimensions");
     #endif
 
@@ -101,11 +104,16 @@ namespace Evaluator::NNUE {
             return !istream.fail();
         }
 
+        // Update the accumulators of both perspectives without transforming
+        void updateAccumulators(Position const &pos) const {
+            updateAccumulator(pos, WHITE);
+            updateAccumulator(pos, BLACK);
+        }
+
         // Convert input features
         void transform(Position const &pos, OutputType *output) const {
 
-            updateAccumulator(pos, WHITE);
-            updateAccumulator(pos, BLACK);
+            updateAccumulators(pos);
 
             auto const &accumulation = pos.state()->accumulator.accumulation;
 
@@ -208,7 +216,7 @@ namespace Evaluator::NNUE {
         #if defined(VECTOR)
             // Gcc-10.2 unnecessarily spills AVX2 registers if this array
             // is defined in the VECTOR code below, once in each branch
-            vec_t acc[NumRegs];
+            vec_t acc[TileRegs];
         #endif
             constexpr int MaxSteps = 6;
             StateInfo *stack[MaxSteps];
@@ -246,7 +254,7 @@ namespace Evaluator::NNUE {
 
                 for (IndexType j = 0; j < HalfDimensions / TileHeight; ++j) {
                     auto accTile = reinterpret_cast<vec_t*>(&si->accumulator.accumulation[c][0][j * TileHeight]);
-                    for (IndexType k = 0; k < NumRegs; ++k) {
+                    for (IndexType k = 0; k < TileRegs; ++k) {
                         acc[k] = vec_load(&accTile[k]);
                     }
                     for (int i = step - 1; i >= 0; --i) {
@@ -254,7 +262,7 @@ namespace Evaluator::NNUE {
                         for (const auto index : removedList[i]) {
                             const IndexType offset = HalfDimensions * index + j * TileHeight;
                             auto column = reinterpret_cast<const vec_t*>(&weights_[offset]);
-                            for (IndexType k = 0; k < NumRegs; ++k) {
+                            for (IndexType k = 0; k < TileRegs; ++k) {
                                 acc[k] = vec_sub_16(acc[k], column[k]);
                             }
                         }
@@ -263,13 +271,13 @@ namespace Evaluator::NNUE {
                         for (const auto index : addedList[i]) {
                             const IndexType offset = HalfDimensions * index + j * TileHeight;
                             auto column = reinterpret_cast<const vec_t*>(&weights_[offset]);
-                            for (IndexType k = 0; k < NumRegs; ++k) {
+                            for (IndexType k = 0; k < TileRegs; ++k) {
                                 acc[k] = vec_add_16(acc[k], column[k]);
                             }
                         }
 
                         accTile = reinterpret_cast<vec_t*>(&stack[i]->accumulator.accumulation[c][0][j * TileHeight]);
-                        for (IndexType k = 0; k < NumRegs; ++k) {
+                        for (IndexType k = 0; k < TileRegs; ++k) {
                             vec_store(&accTile[k], acc[k]);
                         }
                     }
@@ -311,7 +319,7 @@ namespace Evaluator::NNUE {
             #if defined(VECTOR)
                 for (IndexType j = 0; j < HalfDimensions / TileHeight; ++j) {
                     auto biasesTile{ reinterpret_cast<const vec_t*>(&biases_[j * TileHeight]) };
-                    for (IndexType k = 0; k < NumRegs; ++k) {
+                    for (IndexType k = 0; k < TileRegs; ++k) {
                         acc[k] = biasesTile[k];
                     }
 
@@ -319,13 +327,13 @@ namespace Evaluator::NNUE {
                         const IndexType offset = HalfDimensions * index + j * TileHeight;
                         auto column{ reinterpret_cast<const vec_t*>(&weights_[offset]) };
 
-                        for (unsigned k = 0; k < NumRegs; ++k) {
+                        for (unsigned k = 0; k < TileRegs; ++k) {
                             acc[k] = vec_add_16(acc[k], column[k]);
                         }
                     }
 
                     auto accTile{ reinterpret_cast<vec_t*>(&accumulator.accumulation[c][0][j * TileHeight]) };
-                    for (unsigned k = 0; k < NumRegs; ++k) {
+                    for (unsigned k = 0; k < TileRegs; ++k) {
                         vec_store(&accTile[k], acc[k]);
                     }
                 }
@@ -1,5 +1,6 @@
 #include "notation.h"
 
+#include <cctype>
 #include <cmath>
 #include <sstream>
 
@@ -265,14 +266,134 @@ std::string moveToSAN(Move m, Position &pos) {
     return oss.str();
 }
 /// Converts a string representing a move in short algebraic notation
-/// to the corresponding legal move, if any.
+/// to the corresponding legal move, if any (MOVE_NONE if illegal or ambiguous).
+/// The piece, destination and disambiguation are resolved directly from bitboards,
+/// instead of matching moveToSAN() of every legal move, which costs a move generation
+/// per legal move. Check/mate markers and annotations are ignored, "0-0" is also accepted.
 Move moveOfSAN(std::string_view san, Position &pos) {
-    for (auto const &vm : MoveList<LEGAL>(pos)) {
-        if (moveToSAN(vm, pos) == san) {
-            return vm;
+    // Strip check/mate markers and annotations
+    while (!san.empty()
+        && (san.back() == '+'
+         || san.back() == '#'
+         || san.back() == '!'
+         || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+
+    auto const active{ pos.activeSide() };
+
+    if (san == "O-O" || san == "0-0"
+     || san == "O-O-O" || san == "0-0-0") {
+        auto const cs{ san.size() == 3 ? CS_KING : CS_QUEN };
+        if (!pos.canCastle(active, cs)) {
+            return MOVE_NONE;
         }
+        auto const m{ makeMove<CASTLE>(pos.square(active|KING), pos.castleRookSq(active, cs)) };
+        return pos.pseudoLegal(m)
+            && pos.legal(m) ? m : MOVE_NONE;
     }
-    return MOVE_NONE;
+
+    if (san.size() < 2) {
+        return MOVE_NONE;
+    }
+
+    // Moving piece ('b' is a file, 'B' a bishop)
+    PieceType pt{ PAWN };
+    if (std::isupper(san.front())) {
+        auto const p{ toPiece(san.front()) };
+        if (p == NO_PIECE) {
+            return MOVE_NONE;
+        }
+        pt = pType(p);
+        san.remove_prefix(1);
+    }
+    // Promotion ("=Q" or "Q")
+    PieceType promote{ NONE };
+    if (!san.empty()
+     && std::isupper(san.back())) {
+        auto const p{ toPiece(san.back()) };
+        if (pt != PAWN
+         || p == NO_PIECE
+         || pType(p) < NIHT
+         || pType(p) > QUEN) {
+            return MOVE_NONE;
+        }
+        promote = pType(p);
+        san.remove_suffix(1);
+        if (!san.empty()
+         && san.back() == '=') {
+            san.remove_suffix(1);
+        }
+    }
+    // Destination
+    if (san.size() < 2
+     || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h'
+     || san[san.size() - 1] < '1' || san[san.size() - 1] > '8') {
+        return MOVE_NONE;
+    }
+    auto const dst{ makeSquare(toFile(san[san.size() - 2]), toRank(san[san.size() - 1])) };
+    san.remove_suffix(2);
+
+    bool capture{ false };
+    if (!san.empty()
+     && (san.back() == 'x'
+      || san.back() == ':')) {
+        capture = true;
+        san.remove_suffix(1);
+    }
+
+    // Disambiguation (file, rank or square of origin)
+    Bitboard orgs{ pos.pieces(active, pt) };
+    for (char const c : san) {
+        if ('a' <= c && c <= 'h') {
+            orgs &= fileBB(toFile(c));
+        } else
+        if ('1' <= c && c <= '8') {
+            orgs &= rankBB(toRank(c));
+        } else {
+            return MOVE_NONE;
+        }
+    }
+
+    if (pt == PAWN) {
+        // Pushes stay on the file, captures name the file of origin
+        if (capture
+         && san.empty()) {
+            return MOVE_NONE;
+        }
+        if (san.empty()) {
+            orgs &= fileBB(sFile(dst));
+        }
+        orgs &= pawnAttacksBB(~active, dst)
+              | fileBB(sFile(dst));
+        if ((promote != NONE) != (relativeRank(active, dst) == RANK_8)) {
+            return MOVE_NONE;
+        }
+    } else {
+        orgs &= attacksBB(pt, dst, pos.pieces());
+    }
+
+    Move move{ MOVE_NONE };
+    while (orgs != 0) {
+        auto const org{ popLSq(orgs) };
+        auto const m{
+            promote != NONE ?
+                makePromoteMove(org, dst, promote) :
+            pt == PAWN
+         && dst == pos.epSquare()
+         && sFile(org) != sFile(dst) ?
+                makeMove<ENPASSANT>(org, dst) :
+                makeMove<SIMPLE>(org, dst) };
+        if (pos.pseudoLegal(m)
+         && pos.legal(m)) {
+            // Ambiguous move
+            if (move != MOVE_NONE) {
+                return MOVE_NONE;
+            }
+            move = m;
+        }
+    }
+    return move;
 }
 
 /*
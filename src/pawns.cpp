@@ -2,18 +2,22 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 #include "bitboard.h"
+#include "evalparam.h"
 #include "thread.h"
+#include "uci.h"
+#include "helper/string_view.h"
 
 namespace Pawns {
 
-    namespace {
-        // Connected pawn bonus
-        constexpr int32_t Connected[RANKS]{
-            0, 5, 7, 11, 24, 48, 86, 0
-        };
+    Cache GlobalCache;
 
+    namespace {
     #define S(mg, eg) makeScore(mg, eg)
 
         constexpr Score Backward      { S( 8,25) };
@@ -22,11 +26,6 @@ namespace Pawns {
         constexpr Score WeakDoubled   { S(10,55) };
         constexpr Score WeakTwiceLever{ S( 3,55) };
 
-        // Bonus for blocked pawns at 5th or 6th rank
-        constexpr Score BlockedPawn[2]{
-            S(-13, -4), S(-5, 2)
-        };
-
     #undef S
 
     }
@@ -104,7 +103,7 @@ namespace Pawns {
 
             if (supporters != 0
              || phalanxes != 0) {
-                int32_t const v{ Connected[r] * (2 + 1 * (phalanxes != 0) - 1 * opposed)
+                int32_t const v{ EvalParams.Connected[r] * (2 + 1 * (phalanxes != 0) - 1 * opposed)
                                + 22 * popCount(supporters) };
                 sc += makeScore(v, v * (r - RANK_3) / 4);
             } else
@@ -131,7 +130,7 @@ namespace Pawns {
 
             if (blocked
              && r >= RANK_5) {
-                sc += BlockedPawn[r - RANK_5];
+                sc += EvalParams.BlockedPawn[r - RANK_5];
             }
 
             score[Own] += sc;
@@ -141,16 +140,115 @@ namespace Pawns {
     template void Entry::evaluate<WHITE>(Position const&);
     template void Entry::evaluate<BLACK>(Position const&);
 
+    static_assert(sizeof(Entry) % sizeof(uint64_t) == 0
+               && offsetof(Entry, key) == 0, "Entry is stored as words, key first");
+
+    /// Cache::resize() sets the size of the cache in MB (0 disables it), rounded down to a power of 2 slots.
+    void Cache::resize(size_t mbSize) {
+        // The search threads probe and store the cache
+        Threadpool.stopThinking();
+
+        size_t count{ std::min((mbSize << 20) / sizeof(Slot), size_t(1) << 32) };
+        while ((count & (count - 1)) != 0) {
+            count &= count - 1;
+        }
+        if (count != slots.size()) {
+            std::vector<Slot>(count).swap(slots);
+        }
+        clear();
+    }
+
+    void Cache::clear() noexcept {
+        std::fill(slots.begin(), slots.end(), Slot{});
+    }
+
+    /// Cache::probe() copies the entry of the key (if found and not torn) into the given entry
+    bool Cache::probe(Key key, Entry &e) const noexcept {
+        auto const slot{ slots[index(key)] };
+        uint64_t check{ slot.words[0] };
+        for (size_t i = 1; i < DataWords; ++i) {
+            check ^= slot.words[i];
+        }
+        if (check != key) {
+            return false;
+        }
+        std::memcpy(&e, &slot, sizeof(e));
+        e.key = key;
+        return true;
+    }
+
+    /// Cache::store() stores the entry, its key xor-ed with the data words
+    void Cache::store(Entry const &e) noexcept {
+        Slot slot;
+        std::memcpy(&slot, &e, sizeof(e));
+        for (size_t i = 1; i < DataWords; ++i) {
+            slot.words[0] ^= slot.words[i];
+        }
+        slots[index(e.key)] = slot;
+    }
+
+    /// Cache::save() saves the cache to the file
+    void Cache::save(std::string_view cacheFile) const {
+        if (whiteSpaces(cacheFile)
+         || !enabled()) {
+            return;
+        }
+        std::ofstream ofstream{ cacheFile.data(), std::ios::out|std::ios::binary };
+        if (!ofstream.is_open()) {
+            return;
+        }
+        uint64_t const count{ slots.size() };
+        ofstream.write((char const*)(&count), sizeof(count));
+        ofstream.write((char const*)(slots.data()), count * sizeof(Slot));
+        ofstream.close();
+        sync_cout << "info string Pawn cache saved to file \'" << cacheFile << "\'" << sync_endl;
+    }
+    /// Cache::load() loads the cache from the file, resizing it as saved
+    void Cache::load(std::string_view cacheFile) {
+        if (whiteSpaces(cacheFile)) {
+            return;
+        }
+        std::ifstream ifstream{ cacheFile.data(), std::ios::in|std::ios::binary };
+        if (!ifstream.is_open()) {
+            return;
+        }
+        uint64_t count{ 0 };
+        ifstream.read((char*)(&count), sizeof(count));
+        if (!ifstream
+         || count > (uint64_t(1) << 32)
+         || (count & (count - 1)) != 0) {
+            return;
+        }
+        Threadpool.stopThinking();
+        std::vector<Slot>(count).swap(slots);
+        ifstream.read((char*)(slots.data()), count * sizeof(Slot));
+        if (!ifstream) {
+            clear();
+        }
+        ifstream.close();
+        sync_cout << "info string Pawn cache loaded from file \'" << cacheFile << "\'" << sync_endl;
+    }
+
     /// Pawns::probe() looks up a current position's pawn configuration in the pawn hash table
-    /// and returns a pointer to it if found, otherwise a new Entry is computed and stored there.
+    /// and returns a pointer to it if found, otherwise in the global cache (if enabled),
+    /// otherwise a new Entry is computed and stored in both.
     Entry* probe(Position const &pos) {
         Key const pawnKey{ pos.pawnKey() };
-        auto *e{ pos.thread()->pawnTable[pawnKey] };
+        auto *const th{ pos.thread() };
+        auto *e{ th->pawnTable[pawnKey] };
 
         if (e->key == pawnKey) {
             return e;
         }
 
+        if (GlobalCache.enabled()) {
+            ++th->pawnCacheProbes;
+            if (GlobalCache.probe(pawnKey, *e)) {
+                ++th->pawnCacheHits;
+                return e;
+            }
+        }
+
         e->key = pawnKey;
 
         e->blockeds = 0;
@@ -160,6 +258,10 @@ namespace Pawns {
         e->evaluate<BLACK>(pos);
         e->complexity = 12 * pos.count(PAWN)
                       +  9 * e->passedCount();
+
+        if (GlobalCache.enabled()) {
+            GlobalCache.store(*e);
+        }
         return e;
     }
 
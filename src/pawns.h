@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string_view>
+#include <vector>
+
 #include "position.h"
 #include "type.h"
 
@@ -36,5 +39,41 @@ namespace Pawns {
 
     using Table = HashTable<Entry, 0x20000>;
 
+    /// Pawns::Cache is the optional global pawn cache behind the per-thread tables, shared by all threads.
+    /// Unlike them it can be large, survives thread changes and can be saved/loaded along with the TT,
+    /// so pawn structures seen in earlier games (or sessions) need not be evaluated again.
+    /// It is lock-free: a slot stores the key xor-ed with all the data words, so a slot torn by
+    /// concurrent writers fails the key check (it is a miss, the entry is evaluated again).
+    class Cache {
+
+    public:
+
+        void resize(size_t);
+        void clear() noexcept;
+
+        bool enabled() const noexcept { return !slots.empty(); }
+        size_t size() const noexcept { return slots.size(); }
+
+        bool probe(Key, Entry&) const noexcept;
+        void store(Entry const&) noexcept;
+
+        void save(std::string_view) const;
+        void load(std::string_view);
+
+    private:
+
+        /// High bits of the key, the per-thread tables index by the low bits
+        size_t index(Key key) const noexcept { return size_t(key >> 32) & (slots.size() - 1); }
+
+        static constexpr size_t DataWords{ sizeof(Entry) / sizeof(uint64_t) };
+        struct Slot {
+            uint64_t words[DataWords];
+        };
+
+        std::vector<Slot> slots;
+    };
+
+    extern Cache GlobalCache;
+
     extern Entry* probe(Position const&);
 }
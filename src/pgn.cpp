@@ -0,0 +1,389 @@
+#include "pgn.h"
+
+#include <cassert>
+#include <cctype>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "notation.h"
+#include "position.h"
+#include "thread.h"
+#include "helper/memoryhandler.h"
+
+#if defined(_WIN32)
+    // Disable macros min() and max()
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+    #endif
+    // Excludes APIs such as Cryptography, DDE, RPC, Socket
+    #if !defined(WIN32_LEAN_AND_MEAN)
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+
+    #include <Windows.h>
+
+    #undef NOMINMAX
+    #undef WIN32_LEAN_AND_MEAN
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace PGN {
+
+    namespace {
+
+        std::string_view const StartFEN{ "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" };
+
+        /// MappedFile maps a whole file read-only in memory
+        class MappedFile final {
+
+        public:
+
+            explicit MappedFile(std::string const &filename) noexcept {
+
+            #if defined(_WIN32)
+
+                HANDLE hFile = CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (hFile == INVALID_HANDLE_VALUE) {
+                    return;
+                }
+                DWORD hiSize;
+                DWORD const loSize = GetFileSize(hFile, &hiSize);
+                size_t const fileSize{ (size_t(hiSize) << 32) | loSize };
+                if (fileSize != 0) {
+                    HANDLE hFileMap = CreateFileMapping(hFile, nullptr, PAGE_READONLY, hiSize, loSize, nullptr);
+                    if (hFileMap != nullptr) {
+                        void *baseAddress = MapViewOfFile(hFileMap, FILE_MAP_READ, 0, 0, 0);
+                        if (baseAddress != nullptr) {
+                            mapping = (uint64_t)hFileMap;
+                            data = static_cast<char const*>(baseAddress);
+                            size = fileSize;
+                        } else {
+                            CloseHandle(hFileMap);
+                        }
+                    }
+                }
+                CloseHandle(hFile);
+
+            #else
+
+                int32_t hFile = ::open(filename.c_str(), O_RDONLY);
+                if (hFile == -1) {
+                    return;
+                }
+                struct stat statbuf;
+                if (fstat(hFile, &statbuf) == 0
+                 && statbuf.st_size != 0) {
+                    void *baseAddress = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_SHARED, hFile, 0);
+                    if (baseAddress != MAP_FAILED) {
+                    #if defined(MADV_SEQUENTIAL)
+                        madvise(baseAddress, statbuf.st_size, MADV_SEQUENTIAL);
+                    #endif
+                        data = static_cast<char const*>(baseAddress);
+                        size = statbuf.st_size;
+                    }
+                }
+                ::close(hFile);
+
+            #endif
+            }
+
+            ~MappedFile() noexcept {
+                if (data == nullptr) {
+                    return;
+                }
+            #if defined(_WIN32)
+                UnmapViewOfFile(data);
+                CloseHandle((HANDLE)mapping);
+            #else
+                munmap(const_cast<char*>(data), size);
+            #endif
+            }
+
+            MappedFile(MappedFile const&) = delete;
+            MappedFile& operator=(MappedFile const&) = delete;
+
+            char const *data{ nullptr };
+            size_t      size{ 0 };
+
+        private:
+
+            uint64_t mapping{ 0 };
+        };
+
+        /// gameBoundary() returns the offset of the first game starting at or after the offset
+        size_t gameBoundary(std::string_view text, size_t offset) noexcept {
+            if (offset == 0) {
+                return 0;
+            }
+            auto const pos{ text.find("\n[Event ", offset - 1) };
+            return pos != std::string_view::npos ? pos + 1 : text.size();
+        }
+
+        bool isResult(std::string_view token) noexcept {
+            return token == "1-0"
+                || token == "0-1"
+                || token == "1/2-1/2"
+                || token == "*";
+        }
+
+        /// Parser parses the games of a chunk of the PGN text
+        class Parser final {
+
+        public:
+
+            Parser(std::string_view txt, Thread *th, GameHandler const &gh) noexcept :
+                text{ txt },
+                thread{ th },
+                handler{ gh } {
+            }
+
+            Stats parse() {
+                size_t i{ 0 };
+                while (i < text.size()) {
+                    char const c{ text[i] };
+
+                    if (std::isspace(static_cast<unsigned char>(c))) {
+                        ++i;
+                    } else
+                    if (c == '[') {
+                        // A tag after the movetext starts a new game
+                        if (inMovetext) {
+                            endGame();
+                        }
+                        auto const eol{ lineEnd(i) };
+                        parseTag(text.substr(i + 1, eol - i - 1));
+                        i = eol;
+                    } else
+                    if (c == '{') {
+                        auto const off{ text.find('}', i) };
+                        i = off != std::string_view::npos ? off + 1 : text.size();
+                    } else
+                    if (c == ';'
+                     || (c == '%'
+                      && (i == 0 || text[i - 1] == '\n'))) {
+                        i = lineEnd(i);
+                    } else
+                    if (c == '(') {
+                        i = variationEnd(i);
+                    } else
+                    if (c == '$') {
+                        while (++i < text.size()
+                            && std::isdigit(static_cast<unsigned char>(text[i]))) {
+                        }
+                    } else {
+                        auto const beg{ i };
+                        while (i < text.size()
+                            && !std::isspace(static_cast<unsigned char>(text[i]))
+                            && std::string_view{ "{}();[" }.find(text[i]) == std::string_view::npos) {
+                            ++i;
+                        }
+                        if (i == beg) {
+                            ++i; // Stray ')' or '}'
+                            continue;
+                        }
+                        parseToken(text.substr(beg, i - beg));
+                    }
+                }
+                if (inMovetext) {
+                    endGame();
+                }
+                stats.bytes = text.size();
+                return stats;
+            }
+
+        private:
+
+            size_t lineEnd(size_t i) const noexcept {
+                auto const off{ text.find('\n', i) };
+                return off != std::string_view::npos ? off + 1 : text.size();
+            }
+
+            /// variationEnd() skips a (nested) recursive annotation variation
+            size_t variationEnd(size_t i) const noexcept {
+                int32_t depth{ 0 };
+                for (; i < text.size(); ++i) {
+                    if (text[i] == '{') {
+                        auto const off{ text.find('}', i) };
+                        if (off == std::string_view::npos) {
+                            break;
+                        }
+                        i = off;
+                    } else
+                    if (text[i] == '(') {
+                        ++depth;
+                    } else
+                    if (text[i] == ')'
+                     && --depth == 0) {
+                        return i + 1;
+                    }
+                }
+                return text.size();
+            }
+
+            void parseTag(std::string_view tag) {
+                auto const sp{ tag.find(' ') };
+                if (sp == std::string_view::npos) {
+                    return;
+                }
+                auto const name{ tag.substr(0, sp) };
+                if (name == "FEN") {
+                    auto const beg{ tag.find('"', sp) };
+                    auto const end{ tag.rfind('"') };
+                    if (beg != std::string_view::npos
+                     && end > beg) {
+                        game.fen.assign(tag.data() + beg + 1, end - beg - 1);
+                    }
+                }
+            }
+
+            void parseToken(std::string_view token) {
+                if (!inMovetext) {
+                    startGame();
+                }
+                if (isResult(token)) {
+                    game.result.assign(token.data(), token.size());
+                    endGame();
+                    return;
+                }
+                // Skip move number "12." / "12..." (possibly glued to the move "12.e4")
+                size_t n{ 0 };
+                while (n < token.size()
+                    && std::isdigit(static_cast<unsigned char>(token[n]))) {
+                    ++n;
+                }
+                if (n < token.size()
+                 && token[n] == '.') {
+                    while (n < token.size()
+                        && token[n] == '.') {
+                        ++n;
+                    }
+                    token.remove_prefix(n);
+                }
+                if (token.empty()
+                 || invalid) {
+                    return;
+                }
+                if (token == "--") {
+                    invalid = true;
+                    return;
+                }
+
+                auto const move{ moveOfSAN(token, pos) };
+                if (move == MOVE_NONE) {
+                    invalid = true;
+                    return;
+                }
+                game.moves.push_back(move);
+                states.emplace_back();
+                pos.doMove(move, states.back());
+            }
+
+            void startGame() {
+                inMovetext = true;
+                invalid = false;
+                states.clear();
+                states.emplace_back();
+                if (game.fen.empty()) {
+                    game.fen = StartFEN;
+                }
+                // Setup does not validate, so reject at least FENs without both kings
+                pos.setup(game.fen, states.back(), thread);
+                invalid = pos.count(W_KING) != 1
+                       || pos.count(B_KING) != 1;
+            }
+
+            void endGame() {
+                if (invalid) {
+                    ++stats.errors;
+                } else {
+                    ++stats.games;
+                    stats.moves += game.moves.size();
+                    if (handler) {
+                        handler(game);
+                    }
+                }
+                inMovetext = false;
+                game.fen.clear();
+                game.moves.clear();
+                game.result.clear();
+            }
+
+            std::string_view text;
+            Thread *thread;
+            GameHandler const &handler;
+
+            Position pos;
+            std::deque<StateInfo> states;
+            Game  game;
+            bool  inMovetext{ false };
+            bool  invalid{ false };
+            Stats stats;
+        };
+    }
+
+    /// PGN::read() reads all the games of the PGN file with the given number of threads,
+    /// calling the handler (if any) for each valid game, and returns the statistics.
+    Stats read(std::string const &filename, uint16_t threadCount, GameHandler const &handler) {
+
+        MappedFile file{ filename };
+        if (file.data == nullptr) {
+            std::cerr << "ERROR: unable to map file ... \'" << filename << "\'\n";
+            return {};
+        }
+
+        std::string_view const text{ file.data, file.size };
+        threadCount = std::clamp(threadCount, uint16_t(1), uint16_t(std::max(file.size >> 16, size_t(1))));
+
+        // Split the text at the game boundaries nearest to equal parts
+        std::vector<size_t> bounds;
+        for (uint16_t index = 0; index < threadCount; ++index) {
+            bounds.push_back(gameBoundary(text, text.size() / threadCount * index));
+        }
+        bounds.push_back(text.size());
+
+        // Positions need a thread (for the node counter and the table prefetches).
+        // Each parser has a thread object of its own out of the pool, so that parsing never
+        // touches the state of a running search.
+        std::vector<std::unique_ptr<Thread>> parserThreads;
+        for (uint16_t index = 0; index < threadCount; ++index) {
+            parserThreads.emplace_back(new Thread(index));
+        }
+
+        std::vector<Stats> stats(threadCount);
+        std::vector<std::thread> threads;
+        for (uint16_t index = 0; index < threadCount; ++index) {
+            threads.emplace_back(
+                [&, index]() {
+
+                    if (threadCount > 8) {
+                        WinProcGroup::bind(index);
+                    }
+                    auto const beg{ bounds[index] };
+                    auto const end{ std::max(bounds[index + 1], beg) };
+                    Parser parser{ text.substr(beg, end - beg), parserThreads[index].get(), handler };
+                    stats[index] = parser.parse();
+                });
+        }
+        for (auto &th : threads) {
+            th.join();
+        }
+
+        Stats total;
+        for (auto const &s : stats) {
+            total.games  += s.games;
+            total.moves  += s.moves;
+            total.errors += s.errors;
+            total.bytes  += s.bytes;
+        }
+        return total;
+    }
+}
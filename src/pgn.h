@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "type.h"
+
+/// PGN reads the games of a PGN file for books, experience and training data.
+/// The file is mapped in memory and streamed, split at game boundaries ("[Event ")
+/// into chunks parsed in parallel, the SAN moves are decoded directly by moveOfSAN().
+namespace PGN {
+
+    /// Game contains the starting position and the moves of a game
+    struct Game {
+        std::string fen;
+        Moves       moves;
+        std::string result;
+    };
+
+    /// GameHandler is called for each valid game, concurrently by the parsing threads
+    using GameHandler = std::function<void(Game const&)>;
+
+    struct Stats {
+        uint64_t games{ 0 };
+        uint64_t moves{ 0 };
+        uint64_t errors{ 0 };   // Games skipped because of an illegal/unknown move or FEN
+        uint64_t bytes{ 0 };
+    };
+
+    extern Stats read(std::string const&, uint16_t, GameHandler const& = nullptr);
+}
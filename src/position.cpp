@@ -41,9 +41,6 @@ namespace {
 //// initialize() static function
 //void Position::initialize() {}
 
-Key Position::pgKey() const noexcept {
-    return PolyZob.computePosiKey(*this);
-}
 /// Position::movePosiKey() computes the new hash key after the given moven, needed for speculative prefetch.
 /// It doesn't recognize special moves like castling, en-passant and promotions.
 Key Position::movePosiKey(Move m) const noexcept {
@@ -92,6 +89,20 @@ Key Position::movePosiKey(Move m) const noexcept {
     pKey ^= RandZob.enpassantKey(_stateInfo->epSquare);
     return pKey;
 }
+/// Position::moveFlipKey() computes the new colour-flipped hash key after the given move, as movePosiKey().
+Key Position::moveFlipKey(Move m) const noexcept {
+    assert(isOk(m));
+
+    auto fKey{ _stateInfo->flipKey
+             ^ RandZob.side
+             ^ RandZob.flipPsq(board[orgSq(m)], orgSq(m))
+             ^ RandZob.flipPsq(board[orgSq(m)], dstSq(m)) };
+    if (board[dstSq(m)] != NO_PIECE) {
+        fKey ^= RandZob.flipPsq(board[dstSq(m)], dstSq(m));
+    }
+    fKey ^= RandZob.enpassantKey(_stateInfo->epSquare);
+    return fKey;
+}
 
 /// Position::draw() checks whether position is drawn by: Clock Ply Rule, Repetition.
 /// It does not detect Insufficient materials and Stalemate.
@@ -668,12 +679,7 @@ Position& Position::setup(std::string_view ff, StateInfo &si, Thread *th) {
     // 6) Full move number. The number of the full move.
     //    It starts at 1, and is incremented after Black's move.
 
-    std::memset(this, 0, sizeof(*this));
-    std::fill_n(&pieceSquare[0][0], sizeof(pieceSquare) / sizeof(pieceSquare[0][0]), SQ_NONE);
-    std::fill_n(&cslRookSq[0][0], sizeof(cslRookSq) / sizeof(cslRookSq[0][0]), SQ_NONE);
-
-    std::memset(&si, 0, sizeof(si));
-    _stateInfo = &si;
+    reset(si);
 
     std::istringstream iss{ ff.data() };
     iss >> std::noskipws;
@@ -763,12 +769,72 @@ Position& Position::setup(std::string_view ff, StateInfo &si, Thread *th) {
     ply = int16_t(std::max(2 * (ply - 1), 0) + active);
     assert(ply >= 0);
 
+    setupState(th);
+
+    assert(ok());
+    return *this;
+}
+/// Position::setup() initializes the position object with the given packed position.
+Position& Position::setup(PackedPosition const &pp, StateInfo &si, Thread *th) {
+    reset(si);
+
+    for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+        if (pp.board[s] != NO_PIECE) {
+            placePiece(s, pp.board[s]);
+        }
+    }
+    active = pp.active;
+    for (Color const c : { WHITE, BLACK }) {
+        for (CastleSide const cs : { CS_KING, CS_QUEN }) {
+            if (pp.cslRookSq[c][cs] != SQ_NONE) {
+                setCastle(c, pp.cslRookSq[c][cs]);
+            }
+        }
+    }
+    _stateInfo->epSquare = pp.epSquare;
+    _stateInfo->clockPly = pp.clockPly;
+    ply = pp.ply;
+
+    setupState(th);
+
+    assert(ok());
+    return *this;
+}
+/// Position::pack() returns the packed position, which setup() gives back.
+PackedPosition Position::pack() const noexcept {
+    PackedPosition pp;
+    std::copy(std::begin(board), std::end(board), pp.board);
+    for (Color const c : { WHITE, BLACK }) {
+        for (CastleSide const cs : { CS_KING, CS_QUEN }) {
+            pp.cslRookSq[c][cs] = canCastle(c, cs) ? cslRookSq[c][cs] : SQ_NONE;
+        }
+    }
+    pp.epSquare = _stateInfo->epSquare;
+    pp.active = active;
+    pp.clockPly = _stateInfo->clockPly;
+    pp.ply = ply;
+    return pp;
+}
+
+/// Position::reset() clears the position object and makes it use the given state.
+void Position::reset(StateInfo &si) noexcept {
+    std::memset(static_cast<void*>(this), 0, sizeof(*this));
+    std::fill_n(&pieceSquare[0][0], sizeof(pieceSquare) / sizeof(pieceSquare[0][0]), SQ_NONE);
+    std::fill_n(&cslRookSq[0][0], sizeof(cslRookSq) / sizeof(cslRookSq[0][0]), SQ_NONE);
+
+    std::memset(static_cast<void*>(&si), 0, sizeof(si));
+    _stateInfo = &si;
+}
+/// Position::setupState() computes the state of the position set on the board (material, keys, check info).
+void Position::setupState(Thread *th) noexcept {
     npm[WHITE] = computeNPM<WHITE>(*this);
     npm[BLACK] = computeNPM<BLACK>(*this);
 
     _stateInfo->matlKey = RandZob.computeMatlKey(*this);
     _stateInfo->pawnKey = RandZob.computePawnKey(*this);
     _stateInfo->posiKey = RandZob.computePosiKey(*this);
+    _stateInfo->pgKey = PolyZob.computePosiKey(*this);
+    _stateInfo->flipKey = RandZob.computeFlipKey(*this);
     _stateInfo->checkers = attackersTo(square(active|KING)) & pieces(~active);
     setCheckInfo();
 
@@ -776,9 +842,6 @@ Position& Position::setup(std::string_view ff, StateInfo &si, Thread *th) {
     _stateInfo->accumulator.state[BLACK] = Evaluator::NNUE::INIT;
 
     _thread = th;
-
-    assert(ok());
-    return *this;
 }
 /// Position::setup() initializes the position object with the given endgame code string like "KBPKN".
 /// It is mainly an helper to get the material key out of an endgame code.
@@ -813,11 +876,19 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
 
     Key pKey{ _stateInfo->posiKey
             ^ RandZob.side };
+    // Polyglot key is updated along, so that book probing doesn't recompute it from the board
+    Key gKey{ _stateInfo->pgKey
+            ^ PolyZob.side };
 
     // Copy some fields of the old state to our new StateInfo object except the
     // ones which are going to be recalculated from scratch anyway and then switch
     // our state pointer to point to the new (ready to be updated) state.
-    std::memcpy(&si, _stateInfo, offsetof(StateInfo, posiKey));
+    // The accumulator computed ahead for this move from this state is still valid
+    bool const eager{ si.eagerMove == m
+                   && si.prevState == _stateInfo };
+    si.eagerMove = MOVE_NONE;
+
+    std::memcpy(static_cast<void*>(&si), _stateInfo, offsetof(StateInfo, posiKey));
     si.prevState = _stateInfo;
     _stateInfo = &si; // switch to new state
     // Increment ply counters. In particular, clockPly will be reset to zero later on
@@ -828,8 +899,10 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
     _stateInfo->promoted = false;
 
     // Used by NNUE
-    _stateInfo->accumulator.state[WHITE] = Evaluator::NNUE::EMPTY;
-    _stateInfo->accumulator.state[BLACK] = Evaluator::NNUE::EMPTY;
+    if (!eager) {
+        _stateInfo->accumulator.state[WHITE] = Evaluator::NNUE::EMPTY;
+        _stateInfo->accumulator.state[BLACK] = Evaluator::NNUE::EMPTY;
+    }
     _stateInfo->moveInfo.pieceCount = 1;
 
     auto const pasive{ ~active };
@@ -874,6 +947,8 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
         placePiece(rookDst, cpc);
         pKey ^= RandZob.psq[cpc][rookOrg]
               ^ RandZob.psq[cpc][rookDst];
+        gKey ^= PolyZob.psq[cpc][rookOrg]
+              ^ PolyZob.psq[cpc][rookDst];
 
         cpc = NO_PIECE;
     }
@@ -913,6 +988,7 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
             board[cap] = NO_PIECE; // Not done by removePiece()
         }
         pKey ^= RandZob.psq[cpc][cap];
+        gKey ^= PolyZob.psq[cpc][cap];
         _stateInfo->matlKey ^= RandZob.psq[cpc][pieceCount[cpc]];
         prefetch(_thread->matlTable[_stateInfo->matlKey]);
 
@@ -930,11 +1006,14 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
     }
     pKey ^= RandZob.psq[mpc][org]
           ^ RandZob.psq[mpc][dst];
+    gKey ^= PolyZob.psq[mpc][org]
+          ^ PolyZob.psq[mpc][dst];
 
     // Reset enpassant square
     if (_stateInfo->epSquare != SQ_NONE) {
         assert(1 >= _stateInfo->clockPly);
         pKey ^= RandZob.enpassant[sFile(_stateInfo->epSquare)];
+        gKey ^= PolyZob.enpassant[sFile(_stateInfo->epSquare)];
         _stateInfo->epSquare = SQ_NONE;
     }
 
@@ -942,8 +1021,10 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
     if (_stateInfo->castleRights != CR_NONE
      && (sqCastleRight[org]|sqCastleRight[dst]) != CR_NONE) {
         pKey ^= RandZob.castling[_stateInfo->castleRights];
+        gKey ^= PolyZob.castling[_stateInfo->castleRights];
         _stateInfo->castleRights &= ~(sqCastleRight[org]|sqCastleRight[dst]);
         pKey ^= RandZob.castling[_stateInfo->castleRights];
+        gKey ^= PolyZob.castling[_stateInfo->castleRights];
     }
 
     if (pType(mpc) == PAWN
@@ -957,6 +1038,7 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
              && canEnpassant(pasive, org + PawnPush[active])) {
                 _stateInfo->epSquare = org + PawnPush[active];
                 pKey ^= RandZob.enpassant[sFile(_stateInfo->epSquare)];
+                gKey ^= PolyZob.enpassant[sFile(_stateInfo->epSquare)];
             } else
             if (mType(m) == PROMOTE) {
                 assert(pType(mpc) == PAWN
@@ -979,6 +1061,8 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
                 npm[active] += PieceValues[MG][pType(ppc)];
                 pKey ^= RandZob.psq[mpc][dst]
                       ^ RandZob.psq[ppc][dst];
+                gKey ^= PolyZob.psq[mpc][dst]
+                      ^ PolyZob.psq[ppc][dst];
                 _stateInfo->pawnKey ^= RandZob.psq[mpc][dst];
                 _stateInfo->matlKey ^= RandZob.psq[mpc][pieceCount[mpc]]
                                      ^ RandZob.psq[ppc][pieceCount[ppc] - 1];
@@ -1007,8 +1091,26 @@ void Position::doMove(Move m, StateInfo &si, bool isCheck) noexcept {
 
     // Switch sides
     active = pasive;
-    // Update the key with the final value
+    // Update the keys with the final value
     _stateInfo->posiKey = pKey;
+    _stateInfo->pgKey = gKey;
+    // Colour-flipped key (castling rights are ignored) is updated only for the Hash Flip, from the changed pieces
+    if (Threadpool.hashFlip) {
+        auto const &mi{ _stateInfo->moveInfo };
+        Key fKey{ _stateInfo->prevState->flipKey
+                ^ RandZob.side
+                ^ RandZob.enpassantKey(_stateInfo->prevState->epSquare)
+                ^ RandZob.enpassantKey(_stateInfo->epSquare) };
+        for (uint8_t i = 0; i < mi.pieceCount; ++i) {
+            if (mi.org[i] != SQ_NONE) {
+                fKey ^= RandZob.flipPsq(mi.piece[i], mi.org[i]);
+            }
+            if (mi.dst[i] != SQ_NONE) {
+                fKey ^= RandZob.flipPsq(mi.piece[i], mi.dst[i]);
+            }
+        }
+        _stateInfo->flipKey = fKey;
+    }
 
     setCheckInfo();
 
@@ -1112,8 +1214,9 @@ void Position::doNullMove(StateInfo &si) noexcept {
     assert(&si != _stateInfo
         && _stateInfo->checkers == 0);
 
-    std::memcpy(&si, _stateInfo, offsetof(StateInfo, accumulator));
+    std::memcpy(static_cast<void*>(&si), _stateInfo, offsetof(StateInfo, accumulator));
     si.prevState = _stateInfo;
+    si.eagerMove = MOVE_NONE;
     _stateInfo = &si; // switch to new state
 
     ++_stateInfo->clockPly;
@@ -1129,11 +1232,19 @@ void Position::doNullMove(StateInfo &si) noexcept {
     // Reset enpassant square
     if (_stateInfo->epSquare != SQ_NONE) {
         _stateInfo->posiKey ^= RandZob.enpassant[sFile(_stateInfo->epSquare)];
+        _stateInfo->pgKey ^= PolyZob.enpassant[sFile(_stateInfo->epSquare)];
+        if (Threadpool.hashFlip) {
+            _stateInfo->flipKey ^= RandZob.enpassant[sFile(_stateInfo->epSquare)];
+        }
         _stateInfo->epSquare = SQ_NONE;
     }
 
     active = ~active;
     _stateInfo->posiKey ^= RandZob.side;
+    _stateInfo->pgKey ^= PolyZob.side;
+    if (Threadpool.hashFlip) {
+        _stateInfo->flipKey ^= RandZob.side;
+    }
 
     prefetch(TT.cluster(_stateInfo->posiKey)->entry);
     setCheckInfo();
@@ -1445,6 +1556,9 @@ bool Position::ok() const noexcept {
     if (_stateInfo->matlKey != RandZob.computeMatlKey(*this)
      || _stateInfo->pawnKey != RandZob.computePawnKey(*this)
      || _stateInfo->posiKey != RandZob.computePosiKey(*this)
+     || _stateInfo->pgKey != PolyZob.computePosiKey(*this)
+     || (Threadpool.hashFlip
+      && _stateInfo->flipKey != RandZob.computeFlipKey(*this))
      || _stateInfo->checkers != (attackersTo(square(active|KING)) & pieces(~active))
      || popCount(_stateInfo->checkers) > 2
      || _stateInfo->clockPly > 2 * int16_t(Options["Draw MoveCount"])
@@ -35,6 +35,8 @@ struct StateInfo {
 
     // ---Not copied when making a move (will be recomputed anyhow)
     Key         posiKey;        // Hash key of position
+    Key         pgKey;          // Polyglot hash key of position
+    Key         flipKey;        // Hash key of the colour-flipped position (castling rights ignored), kept only with the Hash Flip
     Bitboard    checkers;       // Checkers
     int16_t     repetition;
     PieceType   captured;       // Piece type captured
@@ -48,10 +50,22 @@ struct StateInfo {
     // Used by NNUE
     Evaluator::NNUE::Accumulator accumulator;
     MoveInfo moveInfo;
+    Move        eagerMove{ MOVE_NONE }; // Move the accumulator was computed ahead for, kept by doMove() of it
     
     StateInfo  *prevState;      // Previous StateInfo pointer
 };
 
+/// PackedPosition is the compact form of a position: the board and the fields a FEN gives.
+/// Setup from it skips the FEN parsing, for the positions set up many times (e.g. a tuning set).
+struct PackedPosition {
+    Piece   board[SQUARES];
+    Square  cslRookSq[COLORS][CASTLE_SIDES]; // SQ_NONE without the castling right
+    Square  epSquare;
+    Color   active;
+    int16_t clockPly;
+    int16_t ply;
+};
+
 /// A list to keep track of the position states along the setup moves
 /// (from the start position to the position just before the search starts).
 /// Needed by 'draw by repetition' detection.
@@ -123,7 +137,9 @@ public:
     Key pawnKey() const noexcept;
     Key posiKey() const noexcept;
     Key pgKey() const noexcept;
+    Key flipKey() const noexcept;
     Key movePosiKey(Move) const noexcept;
+    Key moveFlipKey(Move) const noexcept;
 
     Bitboard checkers() const noexcept;
     PieceType captured() const noexcept;
@@ -178,6 +194,9 @@ public:
 
     Position& setup(std::string_view, StateInfo&, Thread* = nullptr);
     Position& setup(std::string_view, Color, StateInfo&);
+    Position& setup(PackedPosition const&, StateInfo&, Thread* = nullptr);
+
+    PackedPosition pack() const noexcept;
 
     void doMove(Move, StateInfo&, bool) noexcept;
     void doMove(Move, StateInfo&) noexcept;
@@ -201,6 +220,9 @@ public:
 
 private:
 
+    void reset(StateInfo&) noexcept;
+    void setupState(Thread*) noexcept;
+
     void placePiece(Square, Piece) noexcept;
     void removePiece(Square) noexcept;
     void movePiece(Square, Square) noexcept;
@@ -332,6 +354,12 @@ inline Key Position::pawnKey() const noexcept {
 inline Key Position::posiKey() const noexcept {
     return _stateInfo->posiKey;
 }
+inline Key Position::pgKey() const noexcept {
+    return _stateInfo->pgKey;
+}
+inline Key Position::flipKey() const noexcept {
+    return _stateInfo->flipKey;
+}
 inline Bitboard Position::checkers() const noexcept {
     return _stateInfo->checkers;
 }
@@ -0,0 +1,204 @@
+#include "recorder.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+#include "notation.h"
+#include "searcher.h"
+#include "timemanager.h"
+#include "uci.h"
+#include "helper/string_view.h"
+
+namespace Recorder {
+
+    namespace {
+
+        std::mutex Mutex;
+        std::ofstream OFStream;
+        TimePoint StartTime{ 0 };
+
+        bool Replaying{ false };
+        std::vector<Summary> Replayed;
+
+        // Stop command received during the current search
+        bool StopCommand{ false };
+
+        /// stopReason() deduces why the search has stopped from its limits
+        std::string stopReason(Depth depth, uint64_t nodes, TimePoint time) {
+            if (StopCommand) {
+                return "stop";
+            }
+            if (Limits.nodes != 0
+             && Limits.nodes <= nodes) {
+                return "nodes";
+            }
+            if (Limits.moveTime != 0
+             && Limits.moveTime <= time) {
+                return "movetime";
+            }
+            if (Limits.depth != DEPTH_ZERO
+             && Limits.depth <= depth) {
+                return "depth";
+            }
+            if (Limits.mate != 0) {
+                return "mate";
+            }
+            if (Limits.useTimeMgmt()) {
+                return TimeMgr.maximum() < time + 10 ? "maximum" : "optimum";
+            }
+            return "other";
+        }
+
+        void write(std::string const &line) {
+            OFStream << now() - StartTime << ' ' << line << std::endl;
+        }
+    }
+
+    /// Recorder::open() closes the current record and opens the new one (if any),
+    /// starting with the current state of the options.
+    void open(std::string const &recordFile) {
+        std::lock_guard<std::mutex> guard(Mutex);
+
+        if (OFStream.is_open()) {
+            OFStream.close();
+        }
+
+        std::string filename{ trim(recordFile) };
+        std::replace(filename.begin(), filename.end(), '\\', '/');
+        if (filename.empty()) {
+            return;
+        }
+
+        OFStream.open(filename, std::ios::out | std::ios::trunc);
+        if (!OFStream.is_open()) {
+            std::cerr << "ERROR: unable to open file ... \'" << filename << "\'\n";
+            return;
+        }
+        StartTime = now();
+        OFStream << "# " << Name << " " << engineInfo() << '\n';
+
+        // Options in insertion order, buttons are actions not state
+        for (size_t idx = 0; idx < Options.size(); ++idx) {
+            for (auto const &[name, option] : Options) {
+                if (option.index == idx
+                 && name != "Record File"
+                 && option.toString().find(" type button") == std::string::npos) {
+                    write("in setoption name " + name + " value " + std::string(std::string_view(option)));
+                }
+            }
+        }
+    }
+
+    /// Recorder::active() returns whether the searches are to be summarized (recording or replaying)
+    bool active() noexcept {
+        return OFStream.is_open()
+            || Replaying;
+    }
+
+    /// Recorder::input() records a command of the UCI input stream
+    void input(std::string const &command) {
+        std::lock_guard<std::mutex> guard(Mutex);
+
+        if (command.find("go") == 0) {
+            StopCommand = false;
+        } else
+        if (command.find("stop") == 0) {
+            StopCommand = true;
+        }
+        // Recording itself is not part of the record
+        if (OFStream.is_open()
+         && !whiteSpaces(command)
+         && command.find("Record File") == std::string::npos) {
+            write("in " + command);
+        }
+    }
+
+    /// Recorder::iteration() records the summary of an iteration of the search
+    void iteration(Depth depth, uint64_t nodes, TimePoint time) {
+        std::lock_guard<std::mutex> guard(Mutex);
+
+        if (OFStream.is_open()) {
+            std::ostringstream oss;
+            oss << "iter depth " << depth << " nodes " << nodes << " time " << time;
+            write(oss.str());
+        }
+    }
+
+    /// Recorder::searchEnd() records the summary of the search
+    void searchEnd(Depth depth, uint64_t nodes, TimePoint time, Move bestMove) {
+        std::lock_guard<std::mutex> guard(Mutex);
+
+        std::ostringstream oss;
+        oss << bestMove;
+        Summary const summary{ depth, nodes, time, stopReason(depth, nodes, time), oss.str() };
+
+        if (Replaying) {
+            Replayed.push_back(summary);
+        }
+        if (OFStream.is_open()) {
+            oss.str("");
+            oss << "end depth " << summary.depth
+                << " nodes " << summary.nodes
+                << " time " << summary.time
+                << " stop " << summary.stop
+                << " bestmove " << summary.bestMove;
+            write(oss.str());
+        }
+    }
+
+    /// Recorder::read() reads the commands and the search summaries of a record
+    bool read(std::string const &recordFile, std::vector<std::pair<TimePoint, std::string>> &commands, std::vector<Summary> &summaries) {
+
+        std::ifstream ifstream{ recordFile, std::ios::in };
+        if (!ifstream.is_open()) {
+            std::cerr << "ERROR: unable to open file ... \'" << recordFile << "\'\n";
+            return false;
+        }
+        std::string line;
+        while (std::getline(ifstream, line)) {
+            if (line.empty()
+             || line[0] == '#') {
+                continue;
+            }
+            std::istringstream iss{ line };
+            TimePoint time;
+            std::string kind;
+            if (!(iss >> time >> kind)) {
+                continue;
+            }
+            if (kind == "in") {
+                std::string command;
+                std::getline(iss >> std::ws, command);
+                commands.emplace_back(time, command);
+            } else
+            if (kind == "end") {
+                Summary summary;
+                std::string token;
+                iss >> token >> summary.depth
+                    >> token >> summary.nodes
+                    >> token >> summary.time
+                    >> token >> summary.stop
+                    >> token >> summary.bestMove;
+                summaries.push_back(summary);
+            }
+        }
+        ifstream.close();
+        return true;
+    }
+
+    void startReplay() noexcept {
+        std::lock_guard<std::mutex> guard(Mutex);
+        Replaying = true;
+        Replayed.clear();
+    }
+
+    /// Recorder::stopReplay() returns the summaries of the replayed searches
+    std::vector<Summary> stopReplay() {
+        std::lock_guard<std::mutex> guard(Mutex);
+        Replaying = false;
+        return std::move(Replayed);
+    }
+}
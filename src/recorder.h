@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "type.h"
+
+/// Recorder records the UCI input stream with timestamps, the option state and the
+/// summaries of the searches (per iteration and final, with the stop reason) in a text file,
+/// so that an incident (a slow move, a time loss) can be replayed later and its performance
+/// compared with the 'replay' command.
+/// Each line starts with the milli-seconds since the record was opened:
+///   <time> in <command>
+///   <time> iter depth <d> nodes <n> time <t>
+///   <time> end depth <d> nodes <n> time <t> stop <reason> bestmove <move>
+namespace Recorder {
+
+    /// Summary of a search
+    struct Summary {
+        Depth       depth;
+        uint64_t    nodes;
+        TimePoint   time;
+        std::string stop;
+        std::string bestMove;
+    };
+
+    extern void open(std::string const&);
+
+    extern bool active() noexcept;
+
+    extern void input(std::string const&);
+    extern void iteration(Depth, uint64_t, TimePoint);
+    extern void searchEnd(Depth, uint64_t, TimePoint, Move);
+
+    /// Replay
+    extern bool read(std::string const&, std::vector<std::pair<TimePoint, std::string>>&, std::vector<Summary>&);
+    extern void startReplay() noexcept;
+    extern std::vector<Summary> stopReplay();
+}
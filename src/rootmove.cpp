@@ -23,7 +23,9 @@ std::ostream& operator<<(std::ostream &ostream, RootMove const &rm) {
 RootMoves::RootMoves(Position const &pos) :
     std::vector<RootMove>() {
 
-    for (auto const &vm : MoveList<LEGAL>(pos)) {
+    MoveList<LEGAL> moveList{ pos };
+    reserve(moveList.size());
+    for (auto const &vm : moveList) {
         *this += vm;
     }
 }
@@ -31,7 +33,9 @@ RootMoves::RootMoves(Position const &pos) :
 RootMoves::RootMoves(Position const &pos, Moves const &filterMoves) :
     std::vector<RootMove>() {
 
-    for (auto const &vm : MoveList<LEGAL>(pos)) {
+    MoveList<LEGAL> moveList{ pos };
+    reserve(moveList.size());
+    for (auto const &vm : moveList) {
         if (filterMoves.empty()
          || filterMoves.contains(vm)) {
             *this += vm;
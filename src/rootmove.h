@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 #include "position.h"
@@ -20,15 +22,29 @@
 ///  - SelDepth
 ///  - PV (really a refutation table in the case of moves which fail low)
 /// Value is normally set at -VALUE_INFINITE for all non-pv moves.
-class RootMove :
-    public std::vector<Move> {
+/// PV is kept in a fixed-capacity inline array, so PV updates never allocate
+/// and copies (per thread at search start, and while sorting) touch only the used part.
+class RootMove {
 
 public:
 
-    //using std::vector<Move>::vector;
+    explicit RootMove(Move m) noexcept :
+        pvSize{ 1 } {
+        pv[0] = m;
+    }
 
-    explicit RootMove(Move m) :
-        std::vector<Move>{ 1, m } {
+    RootMove(RootMove const &rm) noexcept {
+        *this = rm;
+    }
+    RootMove& operator=(RootMove const &rm) noexcept {
+        oldValue = rm.oldValue;
+        newValue = rm.newValue;
+        selDepth = rm.selDepth;
+        tbRank   = rm.tbRank;
+        tbValue  = rm.tbValue;
+        pvSize   = rm.pvSize;
+        std::copy(rm.pv, rm.pv + rm.pvSize, pv);
+        return *this;
     }
 
     bool operator==(RootMove const &rm) const noexcept {
@@ -56,23 +72,48 @@ public:
         return front() != m;
     }
 
-    void operator+=(Move m) {
-        push_back(m);
+    Move  operator[](uint16_t i) const noexcept { assert(i < pvSize); return pv[i]; }
+    Move& operator[](uint16_t i)       noexcept { assert(i < pvSize); return pv[i]; }
+
+    Move front() const noexcept { return pv[0]; }
+
+    Move const* begin() const noexcept { return pv; }
+    Move const*   end() const noexcept { return pv + pvSize; }
+
+    uint16_t size() const noexcept { return pvSize; }
+    bool    empty() const noexcept { return pvSize == 0; }
+
+    void operator+=(Move m) noexcept {
+        if (pvSize < Capacity) {
+            pv[pvSize++] = m;
+        }
+    }
+
+    /// updatePV() keeps the root move and appends the child pv (terminated by MOVE_NONE)
+    void updatePV(Move const *childPV) noexcept {
+        pvSize = 1;
+        while (*childPV != MOVE_NONE
+            && pvSize < Capacity) {
+            pv[pvSize++] = *childPV++;
+        }
     }
-    //void operator-=(Move m) {
-    //    erase(std::remove(begin(), end(), m), end());
-    //}
 
     std::string toString() const;
 
     Value oldValue{ -VALUE_INFINITE },
           newValue{ -VALUE_INFINITE };
-    
+
     Depth selDepth{ DEPTH_ZERO };
 
     int16_t tbRank{ 0 };
     Value   tbValue{ VALUE_ZERO };
 
+    static constexpr uint16_t Capacity{ MAX_PLY + 1 };
+
+private:
+
+    uint16_t pvSize;
+    Move pv[Capacity];
 };
 
 extern std::ostream& operator<<(std::ostream&, RootMove const&);
@@ -123,14 +164,14 @@ public:
     }
 
     void stableSort() noexcept {
-        std::stable_sort(begin(), end());
+        insertionSort(begin(), end(), std::less<RootMove>());
     }
     void stableSort(uint16_t iBeg, uint16_t iEnd) noexcept {
-        std::stable_sort(begin() + iBeg, begin() + iEnd);
+        insertionSort(begin() + iBeg, begin() + iEnd, std::less<RootMove>());
     }
     template<class Pred>
     void stableSort(Pred pred) noexcept {
-        std::stable_sort(begin(), end(), pred);
+        insertionSort(begin(), end(), pred);
     }
 
     void saveValues() {
@@ -143,6 +184,28 @@ public:
     }
 
     std::string toString() const;
+
+private:
+
+    /// insertionSort() is a stable in-place sort, no temporary buffer as std::stable_sort().
+    /// Root moves are almost sorted (only the new PV moves up), so it is also the fastest.
+    template<class Pred>
+    static void insertionSort(iterator iBeg, iterator iEnd, Pred pred) noexcept {
+        if (iBeg == iEnd) {
+            return;
+        }
+        for (auto p{ iBeg + 1 }; p < iEnd; ++p) {
+            if (!pred(*p, *(p - 1))) {
+                continue;
+            }
+            RootMove const rm{ *p };
+            auto q{ p };
+            for (; q != iBeg && pred(rm, *(q - 1)); --q) {
+                *q = *(q - 1);
+            }
+            *q = rm;
+        }
+    }
 };
 
 extern std::ostream& operator<<(std::ostream&, RootMoves const&);
@@ -4,14 +4,18 @@
 #include <cstring> // For memset()
 #include <cmath>
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 #include "evaluator.h"
 #include "movegenerator.h"
 #include "movepicker.h"
 #include "notation.h"
 #include "polyglot.h"
+#include "recorder.h"
 #include "position.h"
 #include "syzygytb.h"
 #include "thread.h"
@@ -24,8 +28,10 @@
 #include "helper/logger.h"
 #include "helper/prng.h"
 #include "helper/reporter.h"
+#include "helper/systeminfo.h"
 
 using Evaluator::evaluate;
+using Searcher::ttKey;
 
 Limit Limits;
 
@@ -37,8 +43,37 @@ namespace SyzygyTB {
     bool    HasRoot;
 }
 
+namespace Searcher {
+
+    /// Searcher::ttKey() returns the key of the position in the TT. With the colour-flip canonical key it is the lower
+    /// of the keys of the position and of its colour-flipped twin (flipped is set if the latter),
+    /// so that both share the entry, the move stored in the orientation of the lower key.
+    /// Only without castling rights.
+    Key ttKey(Position const &pos, bool &flipped) noexcept {
+        flipped = false;
+        auto const posiKey{ pos.posiKey() };
+        if (!Threadpool.hashFlip
+         || pos.castleRights() != CR_NONE) {
+            return posiKey;
+        }
+        auto const flipKey{ pos.flipKey() };
+        flipped = flipKey < posiKey;
+        return flipped ? flipKey : posiKey;
+    }
+}
+
 namespace {
 
+    /// moveTTKey() returns the key of the position after the move in the TT, as ttKey(), to prefetch its cluster
+    Key moveTTKey(Position const &pos, Move move) noexcept {
+        auto const posiKey{ pos.movePosiKey(move) };
+        if (!Threadpool.hashFlip
+         || pos.castleRights() != CR_NONE) {
+            return posiKey;
+        }
+        return std::min(posiKey, pos.moveFlipKey(move));
+    }
+
     /// Stack keeps the information of the nodes in the tree during the search.
     struct Stack {
 
@@ -61,6 +96,9 @@ namespace {
     constexpr uint64_t TTHitAverageWindow{ 4096 };
     constexpr uint64_t TTHitAverageResolution{ 1024 };
 
+    // Target time (ns) between two checks of the limits by the main thread
+    constexpr int64_t TickLatency{ 1000000 };
+
     // Razor and futility margins
     constexpr int32_t RazorMargin{ 510 };
     constexpr Value futilityMargin(Depth d, bool imp) noexcept {
@@ -124,6 +162,53 @@ namespace {
         return VALUE_DRAW + Value(2 * (th->nodes & 1) - 1);
     }
 
+    /// timedEvaluate() is the static evaluation of the node, timed if node timing is enabled
+    Value timedEvaluate(Position const &pos, Thread *th) {
+        if (!Threadpool.nodeTiming) {
+            return evaluate(pos);
+        }
+        auto const startTime{ nowNS() };
+        auto const value{ evaluate(pos) };
+        th->timing.evalTime += nowNS() - startTime;
+        ++th->timing.evalCount;
+        return value;
+    }
+
+    /// eagerUpdate() makes the move ahead and updates the NNUE accumulator of the child in the given state,
+    /// which doMove() of the same move from the same state keeps. Children which will likely be evaluated classically
+    /// (large PSQ imbalance) are skipped. Timed, including the make, if node timing is enabled.
+    void eagerUpdate(Position &pos, Move move, StateInfo &si, Thread *th) {
+        auto const startTime{ Threadpool.nodeTiming ? nowNS() : 0 };
+
+        pos.doMove(move, si, false);
+        bool const update{ !Evaluator::imbalanced(pos) };
+        if (update) {
+            Evaluator::NNUE::updateAccumulators(pos);
+        }
+        pos.undoMove(move);
+        // Not a node of the search
+        th->nodes.fetch_sub(1, std::memory_order::memory_order_relaxed);
+        if (update) {
+            si.eagerMove = move;
+        }
+
+        if (Threadpool.nodeTiming) {
+            th->timing.eagerTime += nowNS() - startTime;
+            th->timing.eagerCount += update;
+        }
+    }
+
+    /// timedNextMove() picks the next move of the node, timed if node timing is enabled
+    Move timedNextMove(MovePicker &movePicker, Thread *th) {
+        if (!Threadpool.nodeTiming) {
+            return movePicker.nextMove();
+        }
+        auto const startTime{ nowNS() };
+        auto const move{ movePicker.nextMove() };
+        th->timing.pickTime += nowNS() - startTime;
+        return move;
+    }
+
     /// updateContinuationStats() updates Stats of the move pairs formed
     /// by moves at ply -1, -2, -4 and -6 with current move.
     void updateContinuationStats(Stack *ss, Piece pc, Square dst, int32_t bonus) noexcept {
@@ -219,16 +304,21 @@ namespace {
 
     /// multipvInfo() formats PV information according to UCI protocol.
     /// UCI requires that all (if any) un-searched PV lines are sent using a previous search score.
-    std::string multipvInfo(Thread const *th, Depth depth, Value alfa, Value beta) {
+    /// With the changed-lines-only output policy the lines after the first are skipped
+    /// if their score, bound and PV are the same as last sent, the PVs are cut to the PV length (if any).
+    std::string multipvInfo(RootMoves const &rootMoves, uint16_t pvCur, Depth depth, Value alfa, Value beta) {
         TimePoint const elapsed{ std::max(TimeMgr.elapsed(), { 1 }) };
         auto const nodes{ Threadpool.accumulate(&Thread::nodes) };
         auto const tbHits{ Threadpool.accumulate(&Thread::tbHits)
-                         + th->rootMoves.size() * SyzygyTB::HasRoot };
+                         + rootMoves.size() * SyzygyTB::HasRoot };
+
+        auto &infoKeys{ Threadpool.mainThread()->infoKeys };
+        infoKeys.resize(Threadpool.pvCount, 0);
 
         std::ostringstream oss;
-        for (uint16_t i = 0; i < Threadpool.pvCount; ++i) {
+        for (uint16_t i = 0; i < Threadpool.pvCount && i < rootMoves.size(); ++i) {
 
-            bool const updated{ th->rootMoves[i].newValue != -VALUE_INFINITE };
+            bool const updated{ rootMoves[i].newValue != -VALUE_INFINITE };
 
             if (i > 0
              && depth == 1
@@ -237,7 +327,7 @@ namespace {
             }
 
             auto d{ updated ? depth : std::max(1, depth - 1) };
-            auto v{ updated ? th->rootMoves[i].newValue : th->rootMoves[i].oldValue };
+            auto v{ updated ? rootMoves[i].newValue : rootMoves[i].oldValue };
 
             if (v == -VALUE_INFINITE) {
                 v = VALUE_ZERO;
@@ -247,46 +337,91 @@ namespace {
                 SyzygyTB::HasRoot
              && std::abs(v) < +VALUE_MATE_1_MAX_PLY };
             if (tb) {
-                v = th->rootMoves[i].tbValue;
+                v = rootMoves[i].tbValue;
+            }
+
+            Bound const bound{
+                !tb
+             && i == pvCur ?
+                    beta <= v ? BOUND_LOWER : v <= alfa ? BOUND_UPPER : BOUND_NONE : BOUND_NONE };
+
+            auto const pvBeg{ rootMoves[i].begin() };
+            auto const pvEnd{ Threadpool.infoPVLength != 0
+                           && Threadpool.infoPVLength < rootMoves[i].size() ?
+                                pvBeg + Threadpool.infoPVLength : rootMoves[i].end() };
+
+            if (Threadpool.infoChanged) {
+                Key key{ Key(v) * 4 + bound };
+                for (auto itr = pvBeg; itr != pvEnd; ++itr) {
+                    key = key * 0x9E3779B97F4A7C15 + Key(*itr);
+                }
+                if (i > 0
+                 && infoKeys[i] == key) {
+                    continue;
+                }
+                infoKeys[i] = key;
             }
 
+            if (oss.tellp() != 0) {
+            oss << '\n';
+            }
             oss << std::setfill('0')
                 << "info"
                 << " depth "    << std::setw(2) << d
-                << " seldepth " << std::setw(2) << th->rootMoves[i].selDepth
+                << " seldepth " << std::setw(2) << rootMoves[i].selDepth
                 << " multipv "  << i + 1
                 << std::setfill(' ')
                 << " score "    << v;
             if (Options["UCI_ShowWDL"]) {
-            oss << wdl(v, th->rootPos.clockPly());
+            oss << wdl(v, Threadpool.mainThread()->rootPos.clockPly());
             }
-            if (!tb
-             && i == th->pvCur) {
-            oss << (beta <= v ? " lowerbound" : v <= alfa ? " upperbound" : "");
-            }
-            oss << " nodes "    << nodes
+            oss << (bound == BOUND_LOWER ? " lowerbound" : bound == BOUND_UPPER ? " upperbound" : "")
+                << " nodes "    << nodes
                 << " time "     << elapsed
                 << " nps "      << nodes * 1000 / elapsed
                 << " tbhits "   << tbHits;
             if (elapsed > 1000) {
             oss << " hashfull " << TT.hashFull();
             }
-            oss << " pv "       << th->rootMoves[i];
-            if (i + 1 < Threadpool.pvCount) {
-            oss << '\n';
-            }
+            oss << " pv ";
+            std::copy(pvBeg, pvEnd, std::ostream_iterator<Move>(oss, " "));
         }
         return oss.str();
     }
 
+    /// printInfo() sends the PV information unless held back by the minimum interval of the output policy,
+    /// a held back block is sent at the end of the search. Forced blocks are always sent.
+    /// The time spent formatting and writing is collected for the bench.
+    void printInfo(RootMoves const &rootMoves, uint16_t pvCur, Depth depth, Value alfa, Value beta, bool force) {
+        auto *const mainThread{ Threadpool.mainThread() };
+
+        auto const time{ nowNS() };
+        if (!force
+         && mainThread->infoBlocks != 0
+         && TimeMgr.elapsed() - mainThread->infoLastTime < Threadpool.infoInterval) {
+            mainThread->infoPending = true;
+            return;
+        }
+        sync_cout << multipvInfo(rootMoves, pvCur, depth, alfa, beta) << sync_endl;
+
+        mainThread->infoLastTime = TimeMgr.elapsed();
+        mainThread->infoPending = false;
+        ++mainThread->infoBlocks;
+        mainThread->infoTime += nowNS() - time;
+    }
+
     /// quienSearch() is quiescence search function, which is called by the main depth limited search function when the remaining depth <= 0.
-    template<bool PVNode>
+    /// Without UseTT (outside of a search) the TT is neither probed nor stored, a local entry stands for it.
+    template<bool PVNode, bool UseTT = true>
     Value quienSearch(Position &pos, Stack *const ss, Value alfa, Value beta, Depth depth = DEPTH_ZERO) {
 
         assert(-VALUE_INFINITE <= alfa && alfa < beta && beta <= +VALUE_INFINITE);
         assert(PVNode || (alfa == beta-1));
         assert(depth <= DEPTH_ZERO);
 
+        // Move lists of this node are given back to the thread arena on return
+        Arena::Scope const arenaScope;
+
         Value actualAlfa;
         Move pv[MAX_PLY+1];
 
@@ -314,11 +449,18 @@ namespace {
 
         Move move;
         // Transposition table lookup.
-        Key const posiKey { pos.posiKey() };
-        auto *const tte   { TT.probe(posiKey, ss->ttHit) };
+        bool ttFlip;
+        Key const posiKey { ttKey(pos, ttFlip) };
+        TEntry noTTE{};
+        auto *const tte   { UseTT ? pos.thread()->tTable->probe(posiKey, ss->ttHit) : (ss->ttHit = false, &noTTE) };
         auto const ttValue{ ss->ttHit ? valueOfTT(tte->value(), ss->ply, pos.clockPly()) : VALUE_NONE };
-        auto       ttMove { ss->ttHit ? tte->move() : MOVE_NONE };
+        auto       ttMove { !ss->ttHit ? MOVE_NONE : ttFlip ? flipMove(tte->move()) : tte->move() };
         auto const ttPV   { ss->ttHit && tte->isPV() };
+        if (Threadpool.searchStats) {
+            // A miss on a full cluster gives its least valuable entry to be replaced
+            pos.thread()->ttReplaces += !ss->ttHit && tte->depth() != DEPTH_OFFSET;
+            pos.thread()->ttHits += ss->ttHit;
+        }
 
         // Decide whether or not to include checks.
         // Fixes also the type of TT entry depth that are going to use.
@@ -463,7 +605,7 @@ namespace {
             }
 
             // Speculative prefetch as early as possible
-            prefetch(TT.cluster(pos.movePosiKey(move)));
+            prefetch(thread->tTable->cluster(moveTTKey(pos, move)));
 
             // Check for legality
             if (!pos.legal(move)) {
@@ -485,7 +627,7 @@ namespace {
 
             // Do the move
             pos.doMove(move, si, giveCheck);
-            auto const value{ -quienSearch<PVNode>(pos, ss+1, -beta, -alfa, depth-1) };
+            auto const value{ -quienSearch<PVNode, UseTT>(pos, ss+1, -beta, -alfa, depth-1) };
             // Undo the move
             pos.undoMove(move);
 
@@ -524,7 +666,7 @@ namespace {
         }
 
         tte->save(posiKey,
-                  bestMove,
+                  ttFlip ? flipMove(bestMove) : bestMove,
                   valueToTT(bestValue, ss->ply),
                   ss->staticEval,
                   qsDepth,
@@ -571,6 +713,9 @@ namespace {
         assert(!(PVNode && cutNode));
         assert(DEPTH_ZERO < depth && depth < MAX_PLY);
 
+        // Arena scope of the node (move picker, searched quiets and captures)
+        Arena::Scope const arenaScope;
+
         // Step 1. Initialize node
         ss->moveCount = 0;
         ss->inCheck = pos.checkers() != 0;
@@ -588,6 +733,7 @@ namespace {
         if (!rootNode) {
             // Step 2. Check for aborted search, immediate draw or maximum ply reached.
             if (Threadpool.stop.load(std::memory_order::memory_order_relaxed)
+             || thread->ponderAbort.load(std::memory_order::memory_order_relaxed)
              || pos.draw(ss->ply)
              || ss->ply >= MAX_PLY) {
                 return !ss->inCheck
@@ -634,13 +780,15 @@ namespace {
         // Don't want the score of a partial search to overwrite
         // a previous full search TT value, so we use a different
         // position key in case of an excluded move.
+        bool ttFlip{ false };
         Key const posiKey { excludedMove == MOVE_NONE ?
-                                pos.posiKey() :
+                                ttKey(pos, ttFlip) :
                                 pos.posiKey() ^ makeKey(excludedMove) };
-        auto *const tte   { TT.probe(posiKey, ss->ttHit) };
+        auto *const tte   { thread->tTable->probe(posiKey, ss->ttHit) };
         auto const ttValue{ ss->ttHit ? valueOfTT(tte->value(), ss->ply, pos.clockPly()) : VALUE_NONE };
         auto       ttMove { rootNode ? thread->rootMoves[thread->pvCur][0] :
-                            ss->ttHit ? tte->move() : MOVE_NONE };
+                           !ss->ttHit ? MOVE_NONE :
+                            ttFlip ? flipMove(tte->move()) : tte->move() };
 
         if (excludedMove == MOVE_NONE) {
             ss->ttPV = PVNode || (ss->ttHit && tte->isPV());
@@ -663,6 +811,10 @@ namespace {
         // ttHitAvg can be used to approximate the running average of ttHit
         thread->ttHitAvg = (TTHitAverageWindow - 1) * thread->ttHitAvg / TTHitAverageWindow
                          + TTHitAverageResolution * ss->ttHit;
+        if (Threadpool.searchStats) {
+            thread->ttReplaces += !ss->ttHit && tte->depth() != DEPTH_OFFSET;
+            thread->ttHits += ss->ttHit;
+        }
 
         // At non-PV nodes we check for an early TT cutoff
         if (!PVNode
@@ -711,7 +863,7 @@ namespace {
 
                 // Force check of time on the next occasion
                 if (thread == Threadpool.mainThread()) {
-                    static_cast<MainThread*>(thread)->tickCount = 0;
+                    static_cast<MainThread*>(thread)->forceTick();
                 }
 
                 if (probeState != SyzygyTB::ProbeState::PS_FAILURE) {
@@ -762,6 +914,8 @@ namespace {
         bool improving;
         Value eval;
         Move move;
+        // Static eval computed in this node, not taken from the TT or the null move
+        bool freshEval{ false };
 
         // Step 6. Static evaluation of the position
         if (ss->inCheck) {
@@ -774,7 +928,8 @@ namespace {
             if (ss->ttHit) {
                 // Never assume anything on values stored in TT.
                 if ((ss->staticEval = eval = tte->eval()) == VALUE_NONE) {
-                    ss->staticEval = eval = evaluate(pos);
+                    ss->staticEval = eval = timedEvaluate(pos, thread);
+                    freshEval = true;
                 }
 
                 if (eval == VALUE_DRAW) {
@@ -786,7 +941,8 @@ namespace {
                     eval = ttValue;
                 }
             } else {
-                ss->staticEval = eval = ((ss-1)->playedMove != MOVE_NULL ? evaluate(pos) : -(ss-1)->staticEval + 2 * VALUE_TEMPO);
+                freshEval = (ss-1)->playedMove != MOVE_NULL;
+                ss->staticEval = eval = (freshEval ? timedEvaluate(pos, thread) : -(ss-1)->staticEval + 2 * VALUE_TEMPO);
 
                 tte->save(posiKey,
                           MOVE_NONE,
@@ -797,6 +953,20 @@ namespace {
                           ss->ttPV);
             }
 
+            // Speculatively update the NNUE accumulator of the ttMove child, which is the most likely to be evaluated,
+            // ahead of the independent pruning and move generation. Only after a static eval by NNUE in this node,
+            // which has just computed the accumulator of the node, the child update is then incremental from it.
+            if (Threadpool.eagerUpdate
+             && Evaluator::useNNUE
+             && freshEval
+             && !Evaluator::imbalanced(pos)
+             && ttMove != MOVE_NONE
+             && excludedMove == MOVE_NONE
+             && pos.legal(ttMove)
+             && !pos.giveCheck(ttMove)) {
+                eagerUpdate(pos, ttMove, si, thread);
+            }
+
             // Step 7. Razoring (~1 Elo)
             if (!rootNode // The RootNode PV handling is not available in qsearch
              && depth == 1
@@ -936,7 +1106,7 @@ namespace {
                     ++probCutCount;
 
                     // Speculative prefetch as early as possible
-                    prefetch(TT.cluster(pos.movePosiKey(move)));
+                    prefetch(thread->tTable->cluster(moveTTKey(pos, move)));
 
                     ss->playedMove = move;
                     ss->pieceStats = &thread->continuationStats[ss->inCheck][captureOrPromotion][pos.movedPiece(move)][dstSq(move)];
@@ -960,7 +1130,7 @@ namespace {
                            && tte->depth() >= depth - 3)) {
 
                             tte->save(posiKey,
-                                      move,
+                                      ttFlip ? flipMove(move) : move,
                                       valueToTT(value, ss->ply),
                                       ss->staticEval,
                                       depth - 3,
@@ -1012,11 +1182,16 @@ namespace {
             ss->ply, ss->killerMoves, counterMove };
 
         uint16_t moveCount{ 0 };
-        Moves quietMoves;   quietMoves.reserve(32);
-        Moves captureMoves; captureMoves.reserve(16);
+        NodeMoves quietMoves;   quietMoves.reserve(32);
+        NodeMoves captureMoves; captureMoves.reserve(16);
+
+        if (Threadpool.searchStats) {
+            ++thread->ordering.nodes;
+            thread->ordering.ttNodes += ttMove != MOVE_NONE;
+        }
 
         // Step 12. Loop through all pseudo-legal moves until no moves remain or a beta cutoff occurs.
-        while ((move = movePicker.nextMove()) != MOVE_NONE) {
+        while ((move = timedNextMove(movePicker, thread)) != MOVE_NONE) {
             assert(isOk(move)
                 && (//ss->inCheck ||
                     pos.pseudoLegal(move)));
@@ -1044,7 +1219,8 @@ namespace {
             ss->moveCount = ++moveCount;
 
             if (rootNode
-             && thread == Threadpool.mainThread()) {
+             && thread == Threadpool.mainThread()
+             && Threadpool.concurrentNodes == 0) {
                 TimePoint const elapsed{ TimeMgr.elapsed() };
                 if (elapsed > 3000) {
                     sync_cout << std::setfill('0')
@@ -1191,7 +1367,7 @@ namespace {
             newDepth += extension;
 
             // Speculative prefetch as early as possible
-            prefetch(TT.cluster(pos.movePosiKey(move)));
+            prefetch(thread->tTable->cluster(moveTTKey(pos, move)));
 
             // Update the current move
             ss->playedMove = move;
@@ -1332,7 +1508,8 @@ namespace {
             // Finished searching the move. If a stop or a cutoff occurred,
             // the return value of the search cannot be trusted,
             // and return immediately without updating best move, PV and TT.
-            if (Threadpool.stop.load(std::memory_order::memory_order_relaxed)) {
+            if (Threadpool.stop.load(std::memory_order::memory_order_relaxed)
+             || thread->ponderAbort.load(std::memory_order::memory_order_relaxed)) {
                 return VALUE_ZERO;
             }
 
@@ -1346,12 +1523,9 @@ namespace {
 
                     rm.newValue = value;
                     rm.selDepth = thread->selDepth;
-                    rm.resize(1);
 
                     assert((ss+1)->pv != nullptr);
-                    for (Move *m = (ss+1)->pv; *m != MOVE_NONE; ++m) {
-                        rm += *m;
-                    }
+                    rm.updatePV((ss+1)->pv);
 
                     // Record how often the best move has been changed in each iteration.
                     // This information is used for time management:
@@ -1386,6 +1560,14 @@ namespace {
                     } else {
                         assert(value >= beta); // Fail high
                         ss->stats = 0;
+
+                        if (Threadpool.searchStats) {
+                            auto const pickStage{ movePicker.pickStage() };
+                            ++thread->ordering.cuts[pickStage];
+                            thread->ordering.cutIndex[pickStage] += moveCount;
+                            thread->ordering.ttCuts += move == ttMove;
+                            thread->ordering.firstCuts += moveCount == 1;
+                        }
                         break;
                     }
                 }
@@ -1479,7 +1661,7 @@ namespace {
             !(rootNode && thread->pvCur != 0)) {
 
             tte->save(posiKey,
-                      bestMove,
+                      ttFlip ? flipMove(bestMove) : bestMove,
                       valueToTT(bestValue, ss->ply),
                       ss->staticEval,
                       depth,
@@ -1506,14 +1688,51 @@ namespace Searcher {
             Reduction[i] = int32_t(r * std::log(i + 0.25 * std::log(i)));
         }
     }
+
+    /// Searcher::quienPV() returns the principal variation of the full window quiescence search,
+    /// the moves leading to the quiet position whose static evaluation is the quiescence value.
+    /// Used to resolve the positions of a tuning set (the evaluation assumes quiet positions).
+    /// Searched without the TT, which belongs to the search: the TT is left untouched and the PV doesn't depend on it.
+    Moves quienPV(Position &pos) {
+
+        Stack stack[MAX_PLY + 10], *ss = stack+7;
+        std::memset(stack, 0, 10 * sizeof(*stack));
+        for (int16_t i = 7; i > 0; --i) {
+            (ss-i)->ply = int16_t(1 - i);
+            (ss-i)->pieceStats = &pos.thread()->continuationStats[0][0][NO_PIECE][0]; // Use as a sentinel
+        }
+        ss->ply = 1;
+
+        Move pv[MAX_PLY+1];
+        ss->pv = pv;
+        quienSearch<true, false>(pos, ss, -VALUE_INFINITE, +VALUE_INFINITE);
+
+        Moves moves;
+        for (auto const *m = pv; *m != MOVE_NONE; ++m) {
+            moves.push_back(*m);
+        }
+        return moves;
+    }
+}
+
+/// Thread::search() is thread search function.
+/// A ponder candidate thread joins the predicted position once the predicted reply has been played.
+void Thread::search() {
+    iterativeDeepening();
+    while (ponderReply != MOVE_NONE
+        && !Threadpool.ponder
+        && !Threadpool.stop) {
+        Threadpool.joinPonder(this);
+        iterativeDeepening();
+    }
 }
 
-/// Thread::search() is thread iterative deepening loop function.
+/// Thread::iterativeDeepening() is thread iterative deepening loop function.
 /// It calls depthSearch() repeatedly with increasing depth until
 /// - Force stop requested.
 /// - Allocated thinking time has been consumed.
 /// - Maximum search depth is reached.
-void Thread::search() {
+void Thread::iterativeDeepening() {
     ttHitAvg = TTHitAverageWindow * TTHitAverageResolution / 2;
 
     int32_t const contemptTime { Options["Contempt Time"] };
@@ -1544,7 +1763,9 @@ void Thread::search() {
     std::copy(&lowPlyStats[2][0], &lowPlyStats.back().back() + 1, &lowPlyStats[0][0]);
     std::fill(&lowPlyStats[MAX_LOWPLY - 2][0], &lowPlyStats.back().back() + 1, 0);
 
-    auto *mainThread{ this == Threadpool.mainThread() ?
+    // In concurrent mode main thread searches its own position like any other thread
+    auto *mainThread{ this == Threadpool.mainThread()
+                   && Threadpool.concurrentNodes == 0 ?
                         static_cast<MainThread*>(this) : nullptr };
 
     double  timeReduction{ 1.0 };
@@ -1569,13 +1790,23 @@ void Thread::search() {
     Move pv[MAX_PLY+1];
     ss->pv = pv;
 
+    // With the MultiPV split the thread searches the PV lines of its own root moves only
+    uint16_t const pvCount{ std::min(Threadpool.pvCount, uint16_t(rootMoves.size())) };
+
     // Iterative deepening loop until requested to stop or the target depth is reached.
+    // With the MultiPV split every thread stops at the target depth, as its group must reach it.
     while (++rootDepth < MAX_PLY
         && !Threadpool.stop
-        && (!mainThread
+        && ((!mainThread
+          && !Threadpool.pvSplit)
          || Limits.depth == DEPTH_ZERO
          || rootDepth <= Limits.depth)) {
 
+        // A ponder candidate thread is of no more use once the predicted reply has been played
+        if (ponderAbort) {
+            break;
+        }
+
         if (mainThread) {
             // Age out PV variability metric
             Threadpool.pvChangesSum /= 2;
@@ -1593,7 +1824,7 @@ void Thread::search() {
         }
 
         // MultiPV loop. Perform a full root search for each PV line.
-        for (pvCur = 0; pvCur < Threadpool.pvCount && !Threadpool.stop; ++pvCur) {
+        for (pvCur = 0; pvCur < pvCount && !Threadpool.stop && !ponderAbort; ++pvCur) {
 
             if (pvCur == pvEnd) {
                 pvBeg = pvEnd;
@@ -1642,7 +1873,8 @@ void Thread::search() {
 
                 // If search has been stopped, break immediately.
                 // Sorting is safe because RootMoves is still valid, although it refers to the previous iteration.
-                if (Threadpool.stop) {
+                if (Threadpool.stop
+                 || ponderAbort) {
                     break;
                 }
 
@@ -1651,7 +1883,7 @@ void Thread::search() {
                  && Threadpool.pvCount == 1
                  && (alfa >= bestValue || bestValue >= beta)
                  && TimeMgr.elapsed() > 3000) {
-                    sync_cout << multipvInfo(mainThread, rootDepth, alfa, beta) << sync_endl;
+                    printInfo(rootMoves, pvCur, rootDepth, alfa, beta, false);
                 }
 
                 // If fail low set new bounds
@@ -1684,15 +1916,29 @@ void Thread::search() {
             rootMoves.stableSort(pvBeg, pvCur + 1);
 
             if (mainThread
+             && !Threadpool.pvSplit
              && (Threadpool.stop
-              || Threadpool.pvCount == pvCur + 1
+              || pvCount == pvCur + 1
               || TimeMgr.elapsed() > 3000)) {
-                sync_cout << multipvInfo(mainThread, rootDepth, alfa, beta) << sync_endl;
+                printInfo(rootMoves, pvCur, rootDepth, alfa, beta, Threadpool.stop);
             }
         }
 
-        if (!Threadpool.stop) {
+        if (!Threadpool.stop
+         && !ponderAbort) {
             finishedDepth = rootDepth;
+
+            if (Threadpool.pvSplit) {
+                Threadpool.publishSplit(this);
+                if (mainThread) {
+                    mainThread->printSplit(false);
+                }
+            }
+
+            if (mainThread
+             && Recorder::active()) {
+                Recorder::iteration(rootDepth, Threadpool.accumulate(&Thread::nodes), TimeMgr.elapsed());
+            }
         }
 
         // Has any of the threads found a "mate in <x>"?
@@ -1726,10 +1972,17 @@ void Thread::search() {
                               + 6 * (Threadpool.bestValue - bestValue)
                               + 6 * (Threadpool.iterValues[Threadpool.iterIdx] - bestValue)) / 825.0, 0.50, 1.50) };
 
-                Threadpool.pvChangesSum += Threadpool.accumulate(&Thread::pvChanges);
+                // The ponder candidate threads search other positions, their PV changes are left out
+                size_t searchCount{ 0 };
+                for (auto const *th : Threadpool) {
+                    if (th->ponderReply == MOVE_NONE) {
+                        Threadpool.pvChangesSum += th->pvChanges;
+                        ++searchCount;
+                    }
+                }
                 // Set pvChanges to 0
                 Threadpool.set(&Thread::pvChanges, { 0 });
-                auto const pvInstability{ 1.00 + 2 * Threadpool.pvChangesSum / Threadpool.size() };
+                auto const pvInstability{ 1.00 + 2 * Threadpool.pvChangesSum / searchCount };
 
                 auto totalTime{ TimeMgr.optimum() * reductionRatio * fallingEval * pvInstability };
                 // Cap used time in case of a single legal move for a better viewer experience in tournaments
@@ -1765,6 +2018,16 @@ void Thread::search() {
             if (SkillMgr.enabled()
              && SkillMgr.canPick(rootDepth)) {
                 SkillMgr.pickBestMove();
+
+                // In low CPU mode the pick is final, searching deeper only burns CPU.
+                if (SkillMgr.lowCPU) {
+                    if (!Threadpool.ponder) {
+                        Threadpool.budgetStop = true;
+                        Threadpool.stop = true;
+                    } else {
+                        Threadpool.stopPonderhit = true;
+                    }
+                }
             }
         }
     }
@@ -1779,6 +2042,32 @@ void Thread::search() {
 void MainThread::search() {
     assert(Threadpool.mainThread() == this);
 
+    // Start ticking at the rate measured in the last search
+    tickCount = tickLimit;
+    tickTime = nowNS();
+
+    infoKeys.clear();
+    infoLastTime = 0;
+    infoPending = false;
+    infoBlocks = 0;
+    infoTime = 0;
+
+    if (Threadpool.concurrentNodes != 0) {
+        TEntry::updateGeneration();
+        Evaluator::NNUE::verify();
+        SkillMgr.setLevel(MaxLevel);
+
+        Threadpool.wakeUpAll();
+        Thread::search();
+        // Keep checking if main thread has finished its iterative deepening before the others
+        while (!Threadpool.stop) {
+            Threadpool.checkConcurrent();
+            std::this_thread::yield();
+        }
+        Threadpool.waitIdleAll();
+        return;
+    }
+
     if (Limits.useTimeMgmt()) {
         // Initialize the time manager before searching.
         TimeMgr.setup(rootPos.activeSide(), rootPos.plyCount());
@@ -1788,6 +2077,9 @@ void MainThread::search() {
 
     Evaluator::NNUE::verify();
 
+    double const cpuTime{ SystemInfo::cpuTime() };
+    SkillMgr.lowCPU = false;
+
     bool think{ true };
 
     if (rootMoves.empty()) {
@@ -1835,13 +2127,18 @@ void MainThread::search() {
             }
 
             PRNG prng(now());
-            double const dbllevel{
-                Options["UCI_LimitStrength"] ?
-                    std::clamp(std::pow((double(Options["UCI_Elo"]) - 1346.6) / 143.4, 1 / 0.806), 0.0, double(MaxLevel)) :
-                    double(Options["Skill Level"]) };
+            double const dbllevel{ optionSkillLevel() };
             uint16_t const intLevel = uint16_t(dbllevel) + ((dbllevel - uint16_t(dbllevel)) * 1024 > prng.rand<uint32_t>() % 1024 ? 1 : 0);
             SkillMgr.setLevel(intLevel);
 
+            SkillMgr.lowCPU = SkillMgr.enabled()
+                           && Options["Skill Low CPU"];
+            if (SkillMgr.lowCPU) {
+                Limits.nodes = Limits.nodes != 0 ?
+                                std::min(Limits.nodes, SkillMgr.nodeBudget()) :
+                                SkillMgr.nodeBudget();
+            }
+
             // Have to play with skill handicap?
             // In this case enable MultiPV search by skill pv size
             // that will use behind the scenes to get a set of possible moves.
@@ -1850,9 +2147,50 @@ void MainThread::search() {
                                             uint16_t(rootMoves.size()));
             assert(Threadpool.pvCount != 0);
 
+            // MultiPV split: partition the root moves over the threads, so that the PV lines
+            // are searched by groups of threads on their own moves instead of by all the threads.
+            // Only for analysis, the time management needs all the root moves on main thread.
+            Threadpool.pvSplit = Options["MultiPV Split"]
+                              && Threadpool.pvCount > 1
+                              && Threadpool.size() > 1
+                              && !SkillMgr.enabled()
+                              && !Limits.useTimeMgmt()
+                              && !Threadpool.ponderSplit;
+            if (Threadpool.pvSplit) {
+                Threadpool.split();
+                splitInfoDepth = DEPTH_ZERO;
+            }
+
             Threadpool.wakeUpAll(); // start non-main threads searching !
             Thread::search();           // start main thread searching !
 
+            // With the MultiPV split the other groups may have still to reach the target depth.
+            // Keep checking the limits (as main thread is no more ticking) and reporting meanwhile.
+            if (Threadpool.pvSplit) {
+                auto const targetDepth{ Limits.depth != DEPTH_ZERO ? Limits.depth : Depth(MAX_PLY - 1) };
+                while (!Threadpool.stop
+                    && Threadpool.splitDepth() < targetDepth) {
+                    forceTick();
+                    tick();
+                    printSplit(false);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+
+            // Low CPU mode: mimic the think time without using CPU,
+            // sleep until the optimum time or the "stop" command.
+            // A stop by the node budget or the pick is slept on, the "stop" command clears it.
+            if ( SkillMgr.lowCPU
+             &&  Options["Skill Sleep"]
+             &&  Limits.useTimeMgmt()
+             && !Threadpool.ponder) {
+                while ((!Threadpool.stop
+                      || Threadpool.budgetStop)
+                    && TimeMgr.elapsed() < TimeMgr.optimum()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+
             // Swap best PV line with the sub-optimal one if skill level is enabled
             if (SkillMgr.enabled()) {
                 rootMoves.bringToFront(SkillMgr.bestMove != MOVE_NONE ? SkillMgr.bestMove : SkillMgr.pickBestMove());
@@ -1887,7 +2225,25 @@ void MainThread::search() {
             bestThread = Threadpool.bestThread();
             // If new best thread then send PV info again
             if (bestThread != this) {
-                sync_cout << multipvInfo(bestThread, bestThread->finishedDepth, -VALUE_INFINITE, +VALUE_INFINITE) << sync_endl;
+                printInfo(bestThread->rootMoves, bestThread->pvCur, bestThread->finishedDepth, -VALUE_INFINITE, +VALUE_INFINITE, true);
+            }
+        }
+        // With the MultiPV split the best move is the best of the merged PV lines
+        if (Threadpool.pvSplit
+         && Threadpool.splitDepth() != DEPTH_ZERO) {
+            bestThread = Threadpool.splitBestThread();
+            printSplit(true);
+        } else
+        // Send the PV info held back by the output interval
+        if (infoPending
+         || Threadpool.pvSplit) {
+            printInfo(bestThread->rootMoves, bestThread->pvCur, bestThread->finishedDepth, -VALUE_INFINITE, +VALUE_INFINITE, true);
+        }
+
+        // Candidate threads stopped before joining the predicted position, which has been played
+        if (!Threadpool.ponder) {
+            for (auto *th : Threadpool) {
+                th->ponderReply = MOVE_NONE;
             }
         }
     }
@@ -1914,6 +2270,26 @@ void MainThread::search() {
         assert(bm != pm);
     }
 
+    // Keep the predicted position, whose likely replies are searched by the ponder candidate threads
+    Threadpool.ponderMove = pm;
+    if (pm != MOVE_NONE
+     && Threadpool.ponderCandidates > 1) {
+        StateInfo si[2];
+        rootPos.doMove(bm, si[0]);
+        rootPos.doMove(pm, si[1]);
+        Threadpool.ponderKey = rootPos.posiKey();
+        rootPos.undoMove(pm);
+        rootPos.undoMove(bm);
+    }
+
+    if (Recorder::active()) {
+        Recorder::searchEnd(bestThread->finishedDepth, Threadpool.accumulate(&Thread::nodes), TimeMgr.elapsed(), bm);
+    }
+
+    if (SkillMgr.lowCPU) {
+        sync_cout << "info string cpu " << std::fixed << std::setprecision(3) << SystemInfo::cpuTime() - cpuTime << " s" << sync_endl;
+    }
+
     // Best move could be MOVE_NONE when searching on a stalemate position.
     sync_cout << "bestmove " << bm;
     if (pm != MOVE_NONE) {
@@ -1922,16 +2298,48 @@ void MainThread::search() {
     std::cout << sync_endl;
 }
 
+/// MainThread::printSplit() sends the merged PV lines of the MultiPV split, when all the groups
+/// have completed a new depth (or forced, at the end of the search)
+void MainThread::printSplit(bool force) {
+    auto const depth{ Threadpool.splitDepth() };
+    if (depth == DEPTH_ZERO
+     || (depth <= splitInfoDepth
+      && !(force
+        && infoPending))) {
+        return;
+    }
+    auto const splitRootMoves{ Threadpool.splitMoves(splitInfoDepth) };
+    printInfo(splitRootMoves, 0, splitInfoDepth, -VALUE_INFINITE, +VALUE_INFINITE, force);
+}
+
+/// MainThread::forceTick() makes the next tick check, keeping the count of the ticks done
+void MainThread::forceTick() noexcept {
+    tickLimit -= tickCount;
+    tickCount = 0;
+}
+
 /// MainThread::tick() is used as timer function.
 /// Used to detect when out of available limit and thus stop the search, also print debug info.
+/// The checks are spaced in time (TickLatency) from the measured rate of ticks, so that the stop
+/// latency does not depend on the speed of the platform, but with a nodes limit they are spaced
+/// in nodes, so that the search stops on the same node.
 void MainThread::tick() {
     static TimePoint reportTime{ now() };
 
     if (--tickCount > 0) {
         return;
     }
-    // When using nodes, ensure checking rate is in range [1, 1024]
-    tickCount = int16_t(Limits.nodes != 0 ? std::clamp(int32_t(Limits.nodes / 1024), 1, 1024) : 1024);
+
+    int64_t const tickNow{ nowNS() };
+    if (Limits.nodes != 0) {
+        // When using nodes, ensure checking rate is in range [1, 1024]
+        tickLimit = int16_t(std::clamp(int32_t(Limits.nodes / 1024), 1, 1024));
+    } else {
+        int64_t const ticks{ tickLimit - tickCount };
+        tickLimit = int16_t(std::clamp(ticks * TickLatency / std::max(tickNow - tickTime, int64_t(1)), int64_t(1), int64_t(0x4000)));
+    }
+    tickCount = tickLimit;
+    tickTime = tickNow;
 
     TimePoint elapsed{ TimeMgr.elapsed() };
     TimePoint time{ TimeMgr.startTime + elapsed };
@@ -1942,6 +2350,11 @@ void MainThread::tick() {
         Reporter::print();
     }
 
+    if (Threadpool.concurrentNodes != 0) {
+        Threadpool.checkConcurrent();
+        return;
+    }
+
     // Do not stop until told so by the GUI.
     if (Threadpool.ponder) {
         return;
@@ -1951,9 +2364,13 @@ void MainThread::tick() {
       && (Threadpool.stopPonderhit
        || TimeMgr.maximum() < elapsed + 10))
      || (Limits.moveTime != 0
-      && Limits.moveTime <= elapsed)
-     || (Limits.nodes != 0
-      && Limits.nodes <= Threadpool.accumulate(&Thread::nodes))) {
+      && Limits.moveTime <= elapsed)) {
+        Threadpool.stop = true;
+    } else
+    if (Limits.nodes != 0
+     && Limits.nodes <= Threadpool.accumulate(&Thread::nodes)) {
+        // In low CPU mode the think time is still to be slept
+        Threadpool.budgetStop = SkillMgr.lowCPU;
         Threadpool.stop = true;
     }
 }
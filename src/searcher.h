@@ -57,9 +57,15 @@ struct Limit {
     Moves     searchMoves;  // Restrict search to these root moves only
 };
 
+class Position;
+
 namespace Searcher {
 
     extern void initialize() noexcept;
+
+    extern Key ttKey(Position const&, bool&) noexcept;
+
+    extern Moves quienPV(Position&);
 }
 
 // Global Limit
@@ -8,6 +8,7 @@ SkillManager SkillMgr;
 
 constexpr SkillManager::SkillManager() noexcept :
     bestMove{ MOVE_NONE },
+    lowCPU{ false },
     level{ MaxLevel } {
 }
 
@@ -19,8 +20,15 @@ bool SkillManager::canPick(Depth depth) const noexcept {
     return depth == 1 + level;
 }
 
+/// SkillManager::nodeBudget() returns the nodes to search in low CPU mode, doubling every two levels:
+/// enough to reach the pick depth at low levels, where the moves are weak anyway.
+uint64_t SkillManager::nodeBudget() const noexcept {
+    return uint64_t(1024) << ((level + 1) / 2);
+}
+
 void SkillManager::setLevel(uint16_t lvl) noexcept {
     level = lvl;
+    bestMove = MOVE_NONE;
 }
 
 /// SkillManager::pickBestMove() chooses best move among a set of RootMoves when playing with a strength handicap,
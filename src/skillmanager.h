@@ -4,6 +4,8 @@
 
 // MaxLevel should be <= MAX_PLY / 12
 constexpr uint16_t MaxLevel{ 20 };
+// Hash size in MB cap of low CPU mode
+constexpr size_t LowCPUHashSize{ 16 };
 
 /// Skill Manager class is used to implement strength limit
 class SkillManager final {
@@ -20,11 +22,15 @@ public:
     bool enabled() const noexcept;
     bool canPick(Depth) const noexcept;
 
+    uint64_t nodeBudget() const noexcept;
+
     void setLevel(uint16_t) noexcept;
 
     Move pickBestMove() noexcept;
 
     Move bestMove;
+    // Low CPU mode: search a node budget with a single thread and a small hash, and stop on the pick
+    bool lowCPU;
 
 private:
 
@@ -0,0 +1,385 @@
+#include "texel.h"
+
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "evaluator.h"
+#include "pgn.h"
+#include "position.h"
+#include "searcher.h"
+#include "thread.h"
+#include "uci.h"
+#include "helper/memoryhandler.h"
+
+namespace Texel {
+
+    namespace {
+
+        /// Sample is a labelled position: its quiet position, packed to be set up without parsing,
+        /// and the game result for white
+        struct Sample {
+            PackedPosition pos;
+            double         result;
+        };
+
+        /// Label is a labelled position of an EPD file, unresolved
+        struct Label {
+            std::string fen;
+            double      result;
+        };
+
+        // Opening plies of the PGN games are skipped, mostly book moves
+        constexpr int16_t OpeningPly{ 8 };
+
+        /// parallel() splits [0, count) in equal parts, each processed by its own worker.
+        /// Worker uses the (idle) search thread of its index, for the tables used by the evaluation.
+        template<typename Func>
+        void parallel(size_t count, uint16_t threadCount, Func const &func) {
+            std::vector<std::thread> threads;
+            for (uint16_t index = 0; index < threadCount; ++index) {
+                threads.emplace_back(
+                    [&, index]() {
+
+                        if (threadCount > 8) {
+                            WinProcGroup::bind(index);
+                        }
+                        func(index, count * index / threadCount, count * (index + 1) / threadCount);
+                    });
+            }
+            for (auto &th : threads) {
+                th.join();
+            }
+        }
+
+        /// quietPosition() packs the quiescence search leaf of the position, false if it is in check
+        bool quietPosition(Position &pos, PackedPosition &pp) {
+            auto const pv{ Searcher::quienPV(pos) };
+            std::vector<StateInfo> states(pv.size());
+            for (size_t i = 0; i < pv.size(); ++i) {
+                pos.doMove(pv[i], states[i]);
+            }
+            bool const quiet{ pos.checkers() == 0 };
+            if (quiet) {
+                pp = pos.pack();
+            }
+            for (size_t i = pv.size(); i > 0; --i) {
+                pos.undoMove(pv[i - 1]);
+            }
+            return quiet;
+        }
+
+        /// parseResult() parses the game result for white of an EPD line, e.g.
+        ///   <fen> c9 "1-0";   <fen> [0.5]   <fen> 1/2-1/2
+        bool parseResult(std::string const &line, double &result) {
+            if (line.find("1/2-1/2") != std::string::npos) { result = 0.5; return true; }
+            if (line.find("1-0") != std::string::npos)     { result = 1.0; return true; }
+            if (line.find("0-1") != std::string::npos)     { result = 0.0; return true; }
+            auto const beg{ line.find('[') };
+            if (beg != std::string::npos) {
+                std::istringstream iss{ line.substr(beg + 1) };
+                return bool(iss >> result)
+                    && 0.0 <= result && result <= 1.0;
+            }
+            return false;
+        }
+
+        bool isNumber(std::string const &token) {
+            return !token.empty()
+                && std::all_of(token.begin(), token.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+        }
+
+        /// readEPD() reads the labelled positions, unresolved
+        std::vector<Label> readEPD(std::string const &filename) {
+            std::vector<Label> labels;
+
+            std::ifstream ifstream{ filename, std::ios::in };
+            if (!ifstream.is_open()) {
+                std::cerr << "ERROR: unable to open file ... \'" << filename << "\'\n";
+                return labels;
+            }
+            std::string line;
+            while (std::getline(ifstream, line)) {
+                std::istringstream iss{ line };
+                std::string fen, token;
+                for (int16_t i = 0; i < 4 && iss >> token; ++i) {
+                    fen += token + ' ';
+                }
+                // Clocks are optional
+                std::string clocks;
+                for (int16_t i = 0; i < 2 && iss >> token && isNumber(token); ++i) {
+                    clocks += token + ' ';
+                }
+                fen += clocks.empty() ? "0 1" : clocks;
+
+                double result;
+                if (parseResult(line, result)) {
+                    labels.push_back({ fen, result });
+                }
+            }
+            ifstream.close();
+            return labels;
+        }
+
+        /// readPositions() reads the labelled positions and resolves them to their quiet positions in parallel.
+        std::vector<Sample> readPositions(std::string const &filename, uint16_t threadCount) {
+
+            std::vector<std::vector<Sample>> samples(threadCount);
+
+            auto const pgn{
+                filename.size() > 4
+             && filename.compare(filename.size() - 4, 4, ".pgn") == 0 };
+
+            if (pgn) {
+                std::vector<PGN::Game> games;
+                std::mutex mutex;
+                PGN::read(filename, threadCount,
+                    [&](PGN::Game const &game) {
+                        if (game.result != "*") {
+                            std::lock_guard<std::mutex> guard(mutex);
+                            games.push_back(game);
+                        }
+                    });
+
+                parallel(games.size(), threadCount,
+                    [&](uint16_t index, size_t beg, size_t end) {
+                        auto *const th{ Threadpool[index] };
+                        auto &quiets{ samples[index] };
+                        Position pos;
+                        for (size_t g = beg; g < end; ++g) {
+                            auto const &game{ games[g] };
+                            double const result{
+                                game.result == "1-0" ? 1.0 :
+                                game.result == "0-1" ? 0.0 : 0.5 };
+
+                            std::vector<StateInfo> states(game.moves.size() + 1);
+                            pos.setup(game.fen, states[0], th);
+                            for (size_t i = 0; i < game.moves.size(); ++i) {
+                                PackedPosition pp;
+                                if (int16_t(i) >= OpeningPly
+                                 && quietPosition(pos, pp)) {
+                                    quiets.push_back({ pp, result });
+                                }
+                                pos.doMove(game.moves[i], states[i + 1]);
+                            }
+                        }
+                    });
+            } else {
+                auto const epds{ readEPD(filename) };
+
+                parallel(epds.size(), threadCount,
+                    [&](uint16_t index, size_t beg, size_t end) {
+                        auto *const th{ Threadpool[index] };
+                        auto &quiets{ samples[index] };
+                        Position pos;
+                        StateInfo si;
+                        for (size_t s = beg; s < end; ++s) {
+                            pos.setup(epds[s].fen, si, th);
+                            // Setup does not validate, so reject at least FENs without both kings
+                            if (pos.count(W_KING) != 1
+                             || pos.count(B_KING) != 1) {
+                                continue;
+                            }
+                            PackedPosition pp;
+                            if (quietPosition(pos, pp)) {
+                                quiets.push_back({ pp, epds[s].result });
+                            }
+                        }
+                    });
+            }
+
+            std::vector<Sample> quiets;
+            for (auto &s : samples) {
+                quiets.insert(quiets.end(), s.begin(), s.end());
+            }
+            return quiets;
+        }
+
+        /// evaluate() computes the classical evaluation for white of all the quiet positions in parallel,
+        /// set up from their packed form.
+        /// The eval caches are cleared first, their entries depend on the parameters.
+        void evaluate(std::vector<Sample> const &samples, std::vector<Value> &values, uint16_t threadCount) {
+            Pawns::GlobalCache.clear();
+            parallel(samples.size(), threadCount,
+                [&](uint16_t index, size_t beg, size_t end) {
+                    auto *const th{ Threadpool[index] };
+                    th->matlTable.clear();
+                    th->pawnTable.clear();
+                    th->kingTable.clear();
+
+                    Position pos;
+                    StateInfo si;
+                    for (size_t s = beg; s < end; ++s) {
+                        pos.setup(samples[s].pos, si, th);
+                        auto const v{ Evaluator::evaluate(pos) };
+                        values[s] = pos.activeSide() == WHITE ? v : -v;
+                    }
+                });
+        }
+
+        /// loss() returns the mean squared error between the results and the winning probabilities
+        double loss(std::vector<Sample> const &samples, std::vector<Value> const &values, double K) {
+            double sum{ 0.0 };
+            for (size_t s = 0; s < samples.size(); ++s) {
+                double const probability{ 1.0 / (1.0 + std::pow(10.0, -K * int32_t(values[s]) / 400.0)) };
+                sum += (samples[s].result - probability) * (samples[s].result - probability);
+            }
+            return sum / samples.size();
+        }
+
+        /// fitK() returns the scaling constant of the logistic function which minimizes the loss
+        /// of the current evaluation, found by ternary search as the loss is unimodal in K.
+        double fitK(std::vector<Sample> const &samples, std::vector<Value> const &values) {
+            double lo{ 0.0 }, hi{ 10.0 };
+            for (int16_t i = 0; i < 100; ++i) {
+                double const k1{ lo + (hi - lo) / 3 };
+                double const k2{ hi - (hi - lo) / 3 };
+                if (loss(samples, values, k1) < loss(samples, values, k2)) {
+                    hi = k2;
+                } else {
+                    lo = k1;
+                }
+            }
+            return (lo + hi) / 2;
+        }
+    }
+
+    /// Texel::tune() tunes the parameters on the labelled positions of the file (EPD or PGN),
+    /// with at most the given number of iterations, each trying a +/-1 step on every parameter
+    /// and keeping it if the loss decreases. The tuned values are written in the format of
+    /// Tune::read_results() to the output and to the result file (if any).
+    /// texel <file> [threads] [iterations] [result file]
+    void tune(std::string const &filename, uint16_t threadCount, uint32_t iterations, std::string const &resultFile) {
+
+        auto params{ Tune::params() };
+        if (params.empty()) {
+            sync_cout << "info string No parameters to tune, build with evaltune=yes or flag them with TUNE()" << sync_endl;
+            return;
+        }
+
+        threadCount = std::clamp(threadCount, uint16_t(1), uint16_t(Threadpool.size()));
+
+        // The evaluation switch and the parameters are shared with a running search
+        Threadpool.stopThinking();
+        // Tune the classical evaluation only
+        bool const useNNUE{ Evaluator::useNNUE };
+        Evaluator::useNNUE = false;
+
+        TimePoint const startTime{ now() };
+
+        auto const samples{ readPositions(filename, threadCount) };
+        if (samples.empty()) {
+            std::cerr << "ERROR: no labelled positions in file ... \'" << filename << "\'\n";
+            Evaluator::useNNUE = useNNUE;
+            return;
+        }
+
+        TimePoint const readTime{ now() };
+
+        std::vector<Value> values(samples.size());
+        uint64_t evalCount{ 0 };
+        TimePoint evalTime{ 0 };
+        auto const evaluateAll = [&]() {
+            TimePoint const time{ now() };
+            evaluate(samples, values, threadCount);
+            evalTime += now() - time;
+            evalCount += samples.size();
+        };
+
+        evaluateAll();
+        double const K{ fitK(samples, values) };
+        double bestLoss{ loss(samples, values, K) };
+
+        std::ostringstream oss;
+        oss << std::right
+            << "\n=================================\n"
+            << "Parameters      :" << std::setw(16) << params.size() << '\n'
+            << "Positions       :" << std::setw(16) << samples.size() << '\n'
+            << "Read time (ms)  :" << std::setw(16) << readTime - startTime << '\n'
+            << "K               :" << std::setw(16) << std::fixed << std::setprecision(4) << K << '\n'
+            << "Loss            :" << std::setw(16) << std::setprecision(8) << bestLoss
+            << "\n---------------------------------\n";
+        std::cerr << oss.str() << '\n';
+
+        for (uint32_t iteration = 1; iteration <= iterations; ++iteration) {
+
+            uint32_t improved{ 0 };
+            for (auto &param : params) {
+                auto const value{ param.get() };
+                for (auto const delta : { +1, -1 }) {
+                    auto const v{ std::clamp(value + delta, param.range.first, param.range.second) };
+                    if (v == value) {
+                        continue;
+                    }
+                    param.set(v);
+                    Tune::post_update();
+                    evaluateAll();
+                    auto const l{ loss(samples, values, K) };
+                    if (l < bestLoss) {
+                        bestLoss = l;
+                        ++improved;
+                        break;
+                    }
+                    param.set(value);
+                    Tune::post_update();
+                }
+            }
+
+            sync_cout
+                << "info string iteration " << iteration
+                << " loss " << std::fixed << std::setprecision(8) << bestLoss
+                << " improved " << improved
+                << " evals/sec " << evalCount * 1000 / std::max(evalTime, { 1 })
+                << sync_endl;
+
+            if (improved == 0) {
+                break;
+            }
+        }
+
+        Evaluator::useNNUE = useNNUE;
+        // Eval caches entries were computed with the last tried parameters
+        Pawns::GlobalCache.clear();
+        for (auto *th : Threadpool) {
+            th->matlTable.clear();
+            th->pawnTable.clear();
+            th->kingTable.clear();
+        }
+
+        TimePoint const elapsed{ std::max(now() - startTime, { 1 }) };
+
+        oss.str("");
+        oss << std::right
+            << "\n=================================\n"
+            << "Total time (ms) :" << std::setw(16) << elapsed << '\n'
+            << "Evaluations     :" << std::setw(16) << evalCount << '\n'
+            << "Evals/second    :" << std::setw(16) << evalCount * 1000 / std::max(evalTime, { 1 }) << '\n'
+            << "Loss            :" << std::setw(16) << std::fixed << std::setprecision(8) << bestLoss
+            << "\n---------------------------------\n";
+        std::cerr << oss.str() << '\n';
+
+        // Tuned values, ready to be pasted in Tune::read_results()
+        oss.str("");
+        for (auto const &param : params) {
+            oss << "TuneResults[\"" << param.name << "\"] = " << param.get() << ";\n";
+        }
+        sync_cout << oss.str() << sync_endl;
+
+        if (!resultFile.empty()) {
+            std::ofstream ofstream{ resultFile, std::ios::out | std::ios::trunc };
+            if (!ofstream.is_open()) {
+                std::cerr << "ERROR: unable to open file ... \'" << resultFile << "\'\n";
+                return;
+            }
+            ofstream << oss.str();
+            ofstream.close();
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/// Texel tunes in-process the TUNE() registered parameters of the classical evaluation.
+/// The labelled positions (EPD with game result, or the positions of the games of a PGN)
+/// are resolved once to their quiescence search leaf, then the classical evaluation of
+/// all of them is computed in parallel and the parameters are optimized by local search
+/// on the logistic loss (mean squared error between the game result and the winning probability).
+namespace Texel {
+
+    extern void tune(std::string const&, uint16_t, uint32_t, std::string const&);
+}
@@ -1,12 +1,17 @@
 #include "thread.h"
 
 #include <cassert>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <unordered_map>
 
+#include "movegenerator.h"
+#include "notation.h"
 #include "searcher.h"
 #include "syzygytb.h"
+#include "timemanager.h"
 #include "transposition.h"
 #include "uci.h"
 #include "helper/memoryhandler.h"
@@ -16,8 +21,11 @@ ThreadPool Threadpool;
 /// Thread constructor launches the thread and waits until it goes to sleep in threadFunc().
 /// Note that 'busy' and 'dead' should be already set.
 Thread::Thread(uint16_t idx) :
+    arena{ ArenaSize },
+    tTable{ &TT },
     dead{ false },
     busy{ true },
+    cleaning{ false },
     index(idx),
     nativeThread(&Thread::threadFunc, this) {
 
@@ -40,6 +48,15 @@ void Thread::wakeUp() {
     condition.notify_one(); // Wake up the thread in threadFunc()
 }
 
+/// Thread::wakeUpToClean() wakes up the thread that will clean its own tables,
+/// so that the threads clean in parallel and first touch their memory on their own NUMA node.
+void Thread::wakeUpToClean() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    cleaning = true;
+    busy = true;
+    condition.notify_one(); // Wake up the thread in threadFunc()
+}
+
 /// Thread::waitIdle() blocks on the condition variable while the thread is busy.
 void Thread::waitIdle() {
     std::unique_lock<std::mutex> uniqueLock(mutex);
@@ -58,6 +75,7 @@ void Thread::threadFunc() {
     if (optionThreads() > 8) {
         WinProcGroup::bind(index);
     }
+    Arena::Current = &arena;
 
     while (true) {
 
@@ -71,6 +89,12 @@ void Thread::threadFunc() {
             return;
         }
 
+        if (cleaning) {
+            cleaning = false;
+            clean();
+            continue;
+        }
+        arena.reset();
         search();
     }
 }
@@ -94,6 +118,15 @@ void Thread::clean() {
     //matlTable.clear();
     //pawnTable.clear();
     //kingTable.clear();
+    pawnCacheProbes = 0;
+    pawnCacheHits = 0;
+    ttReplaces = 0;
+    ttHits = 0;
+    ponderReply = MOVE_NONE;
+    ponderAbort = false;
+    arena.peak = 0;
+    arena.overflows = 0;
+    arena.heapAllocs = 0;
 }
 
 /// MainThread::clean()
@@ -101,6 +134,7 @@ void MainThread::clean() {
     Thread::clean();
 
     tickCount = 0;
+    tickLimit = 1024;
 }
 
 MainThread* ThreadPool::mainThread() const noexcept {
@@ -110,13 +144,20 @@ MainThread* ThreadPool::mainThread() const noexcept {
 Thread* ThreadPool::bestThread() const noexcept {
     Thread *bestTh{ front() };
 
+    // The ponder candidate threads search other positions
     auto minValue{ +VALUE_INFINITE };
     for (auto *th : *this) {
+        if (th->ponderReply != MOVE_NONE) {
+            continue;
+        }
         minValue = std::min(th->rootMoves[0].newValue, minValue);
     }
     // Vote according to value and depth
     std::unordered_map<Move, int64_t> votes;
     for (auto *th : *this) {
+        if (th->ponderReply != MOVE_NONE) {
+            continue;
+        }
         votes[th->rootMoves[0][0]] += int32_t(th->rootMoves[0].newValue - minValue + 14) * int32_t(th->finishedDepth);
 
         if (std::abs(bestTh->rootMoves[0].newValue) < +VALUE_MATE_2_MAX_PLY) {
@@ -170,16 +211,19 @@ void ThreadPool::setup(uint16_t threadCount) {
 
         clean();
         // Reallocate the hash with the new threadpool size
-        TT.autoResize(Options["Hash"]);
+        TT.autoResize(optionHash());
         Searcher::initialize();
     }
 }
 
-/// ThreadPool::clean() clears all the threads in threadpool
+/// ThreadPool::clean() clears all the threads in threadpool, each thread its own tables in parallel
 void ThreadPool::clean() {
 
     for (auto *th : *this) {
-        th->clean();
+        th->wakeUpToClean();
+    }
+    for (auto *th : *this) {
+        th->waitIdle();
     }
     timeReduction = 1.00;
     bestValue = +VALUE_INFINITE;
@@ -191,11 +235,55 @@ void ThreadPool::clean() {
 void ThreadPool::startThinking(Position &pos, StateListPtr &states) {
     stop = false;
     stand = false;
+    budgetStop = false;
 
     stopPonderhit = false;
+    concurrentNodes = 0;
+
+    eagerUpdate = Options["NNUE Eager Update"];
+    nodeTiming = Options["Node Timing"];
+    searchStats = Options["Search Stats"];
+    hashFlip = Options["Hash Flip"];
+    infoInterval = TimePoint(Options["Info Interval"]);
+    infoChanged = Options["Info Changed Lines"];
+    infoPVLength = uint16_t(Options["Info PV Length"]);
+    pvSplit = false;
+    ponderCandidates = uint16_t(Options["Ponder Candidates"]);
 
     RootMoves rootMoves{ pos, Limits.searchMoves };
 
+    // Candidate threads left by a stopped ponder search: the predicted reply has not been played.
+    // If one of the other replies searched has, continue from the root moves of its deepest thread.
+    if (std::any_of(begin(), end(), [](Thread const *th) { return th->ponderReply != MOVE_NONE; })) {
+        Thread *candidateTh{ nullptr };
+        size_t groupSize{ 0 };
+        for (auto *th : *this) {
+            if (th->ponderReply != MOVE_NONE
+             && th->rootPos.posiKey() == pos.posiKey()) {
+                ++groupSize;
+                if (candidateTh == nullptr
+                 || candidateTh->finishedDepth < th->finishedDepth) {
+                    candidateTh = th;
+                }
+            }
+        }
+        if (candidateTh != nullptr) {
+            ++ponderStats.candidateHits;
+            ponderStats.savedTime += (TimeMgr.startTime - ponderStartTime) * TimePoint(groupSize) / TimePoint(size());
+            if (candidateTh->finishedDepth != DEPTH_ZERO
+             && Limits.searchMoves.empty()
+             && candidateTh->rootMoves.size() == rootMoves.size()) {
+                rootMoves = candidateTh->rootMoves;
+                bestValue = rootMoves[0].newValue;
+            }
+            std::ostringstream oss;
+            oss << "candidate hit " << moveToCAN(candidateTh->ponderReply) << " depth " << candidateTh->finishedDepth;
+            printPonderStats(oss.str());
+        } else {
+            printPonderStats("miss");
+        }
+    }
+
     if (!rootMoves.empty()) {
         SyzygyTB::rankRootMoves(pos, rootMoves);
     }
@@ -220,8 +308,15 @@ void ThreadPool::startThinking(Position &pos, StateListPtr &states) {
         th->nodes         = 0;
         th->tbHits        = 0;
         th->pvChanges     = 0;
+        th->ttReplaces    = 0;
+        th->ttHits        = 0;
+        th->publishedDepth = DEPTH_ZERO;
+        th->ponderReply   = MOVE_NONE;
+        th->ponderAbort   = false;
         th->nmpMinPly     = 0;
         th->nmpColor      = COLORS;
+        th->timing.clear();
+        th->ordering.clear();
         th->rootMoves     = rootMoves;
         th->rootPos.setup(fen, th->rootState, th);
         assert(th->rootState.pawnKey == setupStates->back().pawnKey);
@@ -231,11 +326,105 @@ void ThreadPool::startThinking(Position &pos, StateListPtr &states) {
         th->rootState     = setupStates->back();
     }
 
+    ponderSplit = false;
+    if (ponder) {
+        ++ponderStats.searches;
+        ponderStartTime = TimeMgr.startTime;
+        // The position must be the one predicted by the last search, after its ponder move
+        if (ponderCandidates > 1
+         && size() > 1
+         && !rootMoves.empty()
+         && Limits.searchMoves.empty()
+         && ponderMove != MOVE_NONE
+         && ponderKey == pos.posiKey()
+         && setupStates->size() > 1) {
+            ponderFen = fen;
+            ponderRootMoves = rootMoves;
+            splitPonder(pos);
+        }
+    }
+
+    mainThread()->wakeUp();
+}
+
+/// ThreadPool::startConcurrent() sets up each thread with its own root position (cycling through the fens)
+/// and wakes up main thread, which runs all threads as independent single-threaded searches
+/// until each of them has searched the given nodes.
+void ThreadPool::startConcurrent(std::vector<std::string> const &fens, uint64_t nodes) {
+    assert(!fens.empty());
+
+    stop = false;
+    stand = false;
+    budgetStop = false;
+
+    stopPonderhit = false;
+    ponder = false;
+    pvCount = 1;
+    pvSplit = false;
+    ponderSplit = false;
+
+    eagerUpdate = Options["NNUE Eager Update"];
+    nodeTiming = Options["Node Timing"];
+    searchStats = Options["Search Stats"];
+    hashFlip = Options["Hash Flip"];
+
+    concurrentNodes = std::max(nodes, uint64_t(1));
+    concurrentTimes.assign(size(), 0);
+    concurrentCounts.assign(size(), 0);
+
+    for (size_t i = 0; i < size(); ++i) {
+        auto *th{ at(i) };
+        th->rootDepth     = DEPTH_ZERO;
+        th->finishedDepth = DEPTH_ZERO;
+        th->nodes         = 0;
+        th->tbHits        = 0;
+        th->pvChanges     = 0;
+        th->ttReplaces    = 0;
+        th->ttHits        = 0;
+        th->publishedDepth = DEPTH_ZERO;
+        th->ponderReply   = MOVE_NONE;
+        th->ponderAbort   = false;
+        th->nmpMinPly     = 0;
+        th->nmpColor      = COLORS;
+        th->timing.clear();
+        th->ordering.clear();
+        th->rootPos.setup(fens[i % fens.size()], th->rootState, th);
+        th->rootMoves     = RootMoves{ th->rootPos };
+        assert(!th->rootMoves.empty());
+    }
+
     mainThread()->wakeUp();
 }
 
+/// ThreadPool::checkConcurrent() records the time when each thread has searched its nodes
+/// (or has finished its iterative deepening) and stops the search when all threads are done.
+/// Threads that are done keep searching, so the load stays constant until the last one.
+void ThreadPool::checkConcurrent() {
+    TimePoint const elapsed{ std::max(now() - TimeMgr.startTime, TimePoint(1)) };
+
+    bool done{ true };
+    for (size_t i = 0; i < size(); ++i) {
+        if (concurrentTimes[i] != 0) {
+            continue;
+        }
+        auto const *th{ at(i) };
+        auto const nodes{ th->nodes.load(std::memory_order::memory_order_relaxed) };
+        if (nodes >= concurrentNodes
+         || th->rootDepth >= MAX_PLY - 1) {
+            concurrentTimes[i] = elapsed;
+            concurrentCounts[i] = nodes;
+        } else {
+            done = false;
+        }
+    }
+    if (done) {
+        stop = true;
+    }
+}
+
 void ThreadPool::stopThinking() {
     stop = true;
+    budgetStop = false;
     mainThread()->waitIdle();
 }
 
@@ -254,6 +443,221 @@ void ThreadPool::waitIdleAll() {
     }
 }
 
+/// ThreadPool::split() partitions the root moves (round-robin, keeping their order) over the groups
+/// of threads of the MultiPV split (as many as MultiPV at most), thread i being in group i % pvGroups.
+/// Called before the threads are woken up, the main thread having still all the root moves.
+void ThreadPool::split() {
+    RootMoves const rootMoves{ mainThread()->rootMoves };
+
+    // Each group searches up to MultiPV lines, so more groups than MultiPV would only add lines
+    pvGroups = uint16_t(std::min({ size(), rootMoves.size(), size_t(pvCount) }));
+    for (size_t i = 0; i < size(); ++i) {
+        auto *th{ at(i) };
+        th->rootMoves.clear();
+        for (size_t j = i % pvGroups; j < rootMoves.size(); j += pvGroups) {
+            th->rootMoves += rootMoves[j];
+        }
+        th->publishedMoves.clear();
+        th->publishedDepth = DEPTH_ZERO;
+    }
+    splitRootMoves.clear();
+    splitRootDepth = DEPTH_ZERO;
+}
+
+/// ThreadPool::publishSplit() publishes the root moves of the iteration just completed by the thread.
+/// When all the groups have completed a new depth, their root moves of that depth are merged and sorted,
+/// so that their values compare, and the published root moves up to that depth are released.
+/// Every group has the values of its min(MultiPV, moves) best moves, so the first MultiPV are the PV lines.
+void ThreadPool::publishSplit(Thread *th) {
+    std::lock_guard<std::mutex> guard(splitMutex);
+    if (th->publishedMoves.size() <= size_t(th->finishedDepth)) {
+        th->publishedMoves.resize(th->finishedDepth + 1);
+    }
+    th->publishedMoves[th->finishedDepth] = th->rootMoves;
+    th->publishedDepth = th->finishedDepth;
+
+    Depth depth{ MAX_PLY };
+    for (uint16_t g = 0; g < pvGroups; ++g) {
+        depth = std::min(groupThread(g)->publishedDepth, depth);
+    }
+    if (depth <= splitRootDepth) {
+        return;
+    }
+
+    RootMoves rootMoves;
+    for (uint16_t g = 0; g < pvGroups; ++g) {
+        auto const *groupTh{ groupThread(g, depth) };
+        if (groupTh != nullptr) {
+            auto const &publishedMoves{ groupTh->publishedMoves[depth] };
+            rootMoves.insert(rootMoves.end(), publishedMoves.begin(), publishedMoves.end());
+        }
+    }
+    rootMoves.stableSort();
+    splitRootMoves = std::move(rootMoves);
+    splitRootDepth = depth;
+
+    for (auto *t : *this) {
+        for (size_t d = 0; d <= size_t(depth) && d < t->publishedMoves.size(); ++d) {
+            RootMoves{}.swap(t->publishedMoves[d]);
+        }
+    }
+}
+
+/// ThreadPool::groupThread() returns the thread of the group that has published the deepest iteration
+Thread* ThreadPool::groupThread(uint16_t group) const noexcept {
+    auto *groupTh{ at(group) };
+    for (size_t i = group + pvGroups; i < size(); i += pvGroups) {
+        if (groupTh->publishedDepth < at(i)->publishedDepth) {
+            groupTh = at(i);
+        }
+    }
+    return groupTh;
+}
+
+/// ThreadPool::groupThread() returns the thread of the group that has published the given depth (nullptr if none)
+Thread* ThreadPool::groupThread(uint16_t group, Depth depth) const noexcept {
+    for (size_t i = group; i < size(); i += pvGroups) {
+        auto const &publishedMoves{ at(i)->publishedMoves };
+        if (size_t(depth) < publishedMoves.size()
+         && !publishedMoves[depth].empty()) {
+            return at(i);
+        }
+    }
+    return nullptr;
+}
+
+/// ThreadPool::splitDepth() returns the depth completed by all the groups, that of the merged PV lines
+Depth ThreadPool::splitDepth() {
+    std::lock_guard<std::mutex> guard(splitMutex);
+    return splitRootDepth;
+}
+
+/// ThreadPool::splitMoves() returns the merged PV lines, and their depth
+RootMoves ThreadPool::splitMoves(Depth &depth) {
+    std::lock_guard<std::mutex> guard(splitMutex);
+    depth = splitRootDepth;
+    return splitRootMoves;
+}
+
+/// ThreadPool::splitBestThread() sets the main thread (threads are idle) to the merged PV lines,
+/// so that the best move and the result of the search are read from it as without the split
+Thread* ThreadPool::splitBestThread() {
+    auto *th{ mainThread() };
+    th->rootMoves = splitMoves(th->finishedDepth);
+    return th;
+}
+
+/// ThreadPool::splitPonder() gives the second half of the threads to the best replies other than
+/// the predicted one, as valued in the TT by the last search, the first half (with the main thread)
+/// staying on the predicted position. The replies get shares of those threads decreasing with
+/// their distance in value from the predicted reply.
+/// Called on the predicted position, before the threads are woken up.
+void ThreadPool::splitPonder(Position &pos) {
+    auto const ttValue{ [&]() {
+        bool ttFlip;
+        bool ttHit;
+        auto const *const tte{ TT.probe(Searcher::ttKey(pos, ttFlip), ttHit) };
+        return ttHit ? tte->value() : VALUE_NONE;
+    } };
+
+    // Values for the side to move after the reply, the lower the better the reply
+    auto const ponderValue{ ttValue() };
+    std::vector<std::pair<Value, Move>> replies;
+    pos.undoMove(ponderMove);
+    for (auto const &vm : MoveList<LEGAL>(pos)) {
+        if (vm == ponderMove) {
+            continue;
+        }
+        StateInfo si;
+        pos.doMove(vm, si);
+        auto const value{ ttValue() };
+        if (value != VALUE_NONE
+         && MoveList<LEGAL>(pos).size() != 0) {
+            replies.emplace_back(value, vm);
+        }
+        pos.undoMove(vm);
+    }
+    std::stable_sort(replies.begin(), replies.end(), [](auto const &r1, auto const &r2) {
+        return r1.first < r2.first;
+    });
+    replies.resize(std::min(replies.size(), size_t(ponderCandidates - 1)));
+
+    auto const baseValue{ ponderValue != VALUE_NONE ? ponderValue :
+                          !replies.empty() ? replies[0].first : VALUE_ZERO };
+    std::vector<double> weights;
+    double sumWeight{ 0.0 };
+    for (auto const &reply : replies) {
+        weights.push_back(1.0 / (1.0 + double(std::max(int32_t(reply.first - baseValue), 0)) / VALUE_EG_PAWN));
+        sumWeight += weights.back();
+    }
+
+    // The threads are given from the last one
+    size_t const first{ (size() + 1) / 2 };
+    size_t i{ size() };
+    for (size_t r = 0; r < replies.size() && i > first; ++r) {
+        auto const move{ replies[r].second };
+        auto count{ std::clamp(size_t(weights[r] * (size() - first) / sumWeight + 0.5), size_t(1), i - first) };
+
+        StateInfo state;
+        pos.doMove(move, state);
+        auto const fen{ pos.fen() };
+        for (; count != 0; --count) {
+            auto *th{ at(--i) };
+            th->ponderReply = move;
+            th->rootPos.setup(fen, th->rootState, th);
+            th->rootState   = state;
+            th->rootMoves   = RootMoves{ th->rootPos };
+            SyzygyTB::rankRootMoves(th->rootPos, th->rootMoves);
+        }
+        pos.undoMove(move);
+    }
+    pos.doMove(ponderMove, setupStates->back());
+
+    ponderSplit = i < size();
+}
+
+/// ThreadPool::joinPonder() sets a candidate thread on the predicted position, once played (ponderhit)
+void ThreadPool::joinPonder(Thread *th) {
+    std::lock_guard<std::mutex> guard(ponderMutex);
+    th->ponderReply   = MOVE_NONE;
+    th->ponderAbort   = false;
+    th->rootDepth     = DEPTH_ZERO;
+    th->finishedDepth = DEPTH_ZERO;
+    th->nmpMinPly     = 0;
+    th->nmpColor      = COLORS;
+    th->rootPos.setup(ponderFen, th->rootState, th);
+    th->rootState     = setupStates->back();
+    th->rootMoves     = ponderRootMoves;
+}
+
+/// ThreadPool::ponderhit() switches the ponder search to a normal search, the predicted reply has been played.
+/// The candidate threads abort their iteration, then join the predicted position.
+void ThreadPool::ponderhit() {
+    std::lock_guard<std::mutex> guard(ponderMutex);
+    if (ponder) {
+        size_t const groupSize( std::count_if(begin(), end(), [](Thread const *th) { return th->ponderReply == MOVE_NONE; }) );
+        ++ponderStats.hits;
+        ponderStats.savedTime += (now() - ponderStartTime) * TimePoint(groupSize) / TimePoint(size());
+        if (ponderCandidates > 1) {
+            printPonderStats("hit");
+        }
+    }
+    ponder = false;
+    for (auto *th : *this) {
+        if (th->ponderReply != MOVE_NONE) {
+            th->ponderAbort = true;
+        }
+    }
+}
+
+/// ThreadPool::printPonderStats() sends the pondering statistics after a ponder search has been resolved
+void ThreadPool::printPonderStats(std::string const &event) const {
+    sync_cout << "info string ponder " << event
+              << " hits " << ponderStats.hits << '/' << ponderStats.searches
+              << " candidate hits " << ponderStats.candidateHits << '/' << ponderStats.searches
+              << " saved " << ponderStats.savedTime << " ms" << sync_endl;
+}
+
 /// Used to serialize access to std::cout to avoid multiple threads writing at the same time.
 std::ostream& operator<<(std::ostream &ostream, OutputState outputState) {
     static std::mutex mutex;
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "thread_win32_osx.h"
@@ -14,8 +15,55 @@
 #include "king.h"
 #include "material.h"
 #include "pawns.h"
+#include "transposition.h"
 #include "type.h"
 
+/// NodeTiming contains the per-node timing counters of a thread, in nano-seconds.
+/// They are collected only with the "Node Timing" option, the clock reads are not free.
+struct NodeTiming {
+
+    void clear() noexcept {
+        evalCount = 0; evalTime = 0;
+        eagerCount = 0; eagerTime = 0;
+        pickTime = 0; quietValueTime = 0; sortTime = 0;
+    }
+
+    uint64_t evalCount;     // Static evaluations of depthSearch()
+    uint64_t evalTime;
+    uint64_t eagerCount;    // Eager NNUE accumulator updates of ttMove child
+    uint64_t eagerTime;
+    uint64_t pickTime;      // MovePicker::nextMove() of depthSearch()
+    uint64_t quietValueTime;// of which quiets valuing
+    uint64_t sortTime;      // and quiets partial sort
+};
+
+/// MoveOrdering contains the move ordering counters of the depthSearch() nodes of a thread,
+/// the beta cut-offs by stage of the cut-off move with the sum of their move index (1 for the first move).
+struct MoveOrdering {
+
+    void clear() noexcept {
+        *this = MoveOrdering{};
+    }
+
+    void operator+=(MoveOrdering const &mo) noexcept {
+        nodes     += mo.nodes;
+        ttNodes   += mo.ttNodes;
+        ttCuts    += mo.ttCuts;
+        firstCuts += mo.firstCuts;
+        for (uint8_t i = 0; i < PICK_STAGES; ++i) {
+            cuts[i]     += mo.cuts[i];
+            cutIndex[i] += mo.cutIndex[i];
+        }
+    }
+
+    uint64_t nodes;                 // Nodes looping through the moves
+    uint64_t ttNodes;               // of which with a ttMove
+    uint64_t ttCuts;                // Cut-offs by the ttMove
+    uint64_t firstCuts;             // Cut-offs by the first move
+    uint64_t cuts[PICK_STAGES];
+    uint64_t cutIndex[PICK_STAGES];
+};
+
 /// Thread class keeps together all the thread-related stuff.
 /// It use pawn and material hash tables so that once get a pointer to
 /// an entry its life time is unlimited and we don't have to care about
@@ -24,6 +72,9 @@ class Thread {
 
 public:
 
+    // Capacity of the arena (1 MB), allocated besides the thread object
+    static constexpr size_t ArenaSize{ 0x100000 };
+
     explicit Thread(uint16_t);
     virtual ~Thread();
 
@@ -35,16 +86,24 @@ public:
     Thread& operator=(Thread&&) = delete;
 
     void wakeUp();
+    void wakeUpToClean();
     void waitIdle();
 
     void threadFunc();
 
     virtual void clean();
     virtual void search();
+    void iterativeDeepening();
 
     Material::Table matlTable;
     Pawns   ::Table pawnTable;
     King    ::Table kingTable;
+    // Global pawn cache lookups on pawn table misses
+    uint64_t pawnCacheProbes;
+    uint64_t pawnCacheHits;
+
+    // Arena of the node-scoped move lists, reset at each search
+    Arena arena;
 
     //uint16_t pvBeg;
     uint16_t pvCur;
@@ -67,6 +126,26 @@ public:
 
     uint64_t ttHitAvg;
 
+    // Table probed by the search: the global TT, or the private table of a concurrent bench instance
+    TTable *tTable;
+
+    // Root moves of the iterations completed (by depth) and depth of the last one, published for the MultiPV split
+    // (only the depths not yet completed by all the groups are kept, the others are merged and released)
+    std::vector<RootMoves> publishedMoves;
+    Depth     publishedDepth;
+    // TT entries replaced by this search (with Search Stats)
+    uint64_t ttReplaces;
+    // TT probes that hit, in the search and the quiescence search (with Search Stats)
+    uint64_t ttHits;
+    // Reply other than the predicted one whose position the thread searches while pondering
+    // (atomic as the thread clears it on joining the predicted position, read by ponderhit())
+    std::atomic<Move> ponderReply;
+    // Raised on ponderhit for a candidate thread, whose position is no more to be searched
+    std::atomic<bool> ponderAbort;
+
+    NodeTiming timing;
+    MoveOrdering ordering;
+
     Score   contempt;
     
     int16_t failHighCount;
@@ -96,6 +175,7 @@ private:
     std::condition_variable condition;
     bool dead;
     bool busy;
+    bool cleaning; // Woken up to clean, not to search
     uint16_t index; // indentity
     NativeThread nativeThread;
 };
@@ -116,11 +196,24 @@ public:
     MainThread& operator=(MainThread&&) = delete;
 
     void tick();
+    void forceTick() noexcept;
+
+    void printSplit(bool);
 
     void clean() final;
     void search() final;
 
     int16_t tickCount;
+    int16_t tickLimit;  // Ticks between two checks, adapted to the measured tick rate
+    int64_t tickTime;   // Time (ns) of the last check
+
+    // PV info output of the current search
+    std::vector<Key> infoKeys;  // Key of the last sent lines (score, bound, PV)
+    TimePoint infoLastTime;     // Time of the last sent block
+    bool      infoPending;      // Block held back by the output interval
+    uint32_t  infoBlocks;       // Blocks sent
+    Depth     splitInfoDepth;   // Depth of the last merged lines sent with the MultiPV split
+    uint64_t  infoTime;         // Time (ns) spent formatting and writing the blocks
 };
 
 
@@ -154,6 +247,13 @@ public:
         }
         return value;
     }
+    template<typename T>
+    T accumulate(T Thread::*member, T value = {}) const noexcept {
+        for (auto const *th : *this) {
+            value += th->*member;
+        }
+        return value;
+    }
 
     MainThread* mainThread() const noexcept;
     Thread* bestThread() const noexcept;
@@ -164,13 +264,51 @@ public:
     void startThinking(Position&, StateListPtr&);
     void stopThinking();
 
+    void startConcurrent(std::vector<std::string> const&, uint64_t);
+    void checkConcurrent();
+
     void wakeUpAll();
     void waitIdleAll();
 
+    void split();
+    void publishSplit(Thread*);
+    Depth splitDepth();
+    RootMoves splitMoves(Depth&);
+    Thread* splitBestThread();
+
+    void splitPonder(Position&);
+    void joinPonder(Thread*);
+    void ponderhit();
+
     uint16_t pvCount;
+    bool     pvSplit;           // MultiPV split: groups of threads search the PV lines of their own root moves
+    uint16_t pvGroups;
+
+    // Multi-candidate pondering: groups of threads search the likely replies other than the predicted one
+    uint16_t ponderCandidates;
+    bool     ponderSplit;
+    Move     ponderMove;        // Move sent with the last "bestmove"
+    Key      ponderKey;         // Key of the position after the best move and the ponder move
+    struct PonderStats {
+        uint32_t  searches;
+        uint32_t  hits;           // The predicted reply played
+        uint32_t  candidateHits;  // Another searched reply played
+        TimePoint savedTime;      // Time searched on the replies played (per thread of the pool)
+    } ponderStats;
+
+    bool    eagerUpdate;        // Update NNUE accumulator of ttMove child eagerly
+    bool    nodeTiming;         // Collect per-node timing counters
+    bool    searchStats;        // Collect per-node search counters (move ordering)
+    bool    hashFlip;           // Probe the TT with the colour-flip canonical key
+
+    // PV info output policy
+    TimePoint infoInterval;     // Minimum time between two blocks
+    bool      infoChanged;      // Send only the changed lines (besides the first)
+    uint16_t  infoPVLength;     // Maximum PV length (0 for full)
 
     std::atomic<bool> stop;     // Stop searching forcefully
     std::atomic<bool> stand;    // Stop increasing depth
+    std::atomic<bool> budgetStop; // Stopped by the low CPU node budget or pick, not by a "stop" command
 
     std::atomic<bool> ponder;   // Search in ponder mode, on ponder move until the "stop"/"ponderhit" command
     bool    stopPonderhit;      // Stop search on ponderhit
@@ -184,9 +322,30 @@ public:
     std::array<Value, 4> iterValues;
     int16_t iterIdx;
 
+    // Concurrent (throughput) mode: every thread searches its own root position
+    // as an independent single-threaded search of concurrentNodes nodes.
+    uint64_t concurrentNodes;
+    std::vector<TimePoint> concurrentTimes;  // Time when each thread has searched its nodes (0 if not yet)
+    std::vector<uint64_t>  concurrentCounts; // Nodes searched by each thread at that time
+
 private:
 
+    Thread* groupThread(uint16_t) const noexcept;
+    Thread* groupThread(uint16_t, Depth) const noexcept;
+
     StateListPtr setupStates;
+
+    std::mutex splitMutex;
+    RootMoves splitRootMoves;   // Merged PV lines of the MultiPV split at the depth completed by all the groups
+    Depth     splitRootDepth;
+    std::mutex ponderMutex; // Serializes ponderhit() with the candidate threads joining the predicted position
+
+    // Predicted position, joined by the candidate threads on ponderhit
+    std::string ponderFen;
+    RootMoves   ponderRootMoves;
+    TimePoint   ponderStartTime;
+
+    void printPonderStats(std::string const&) const;
 };
 
 // Global ThreadPool
@@ -13,6 +13,7 @@
 #include "uci.h"
 #include "helper/string_view.h"
 #include "helper/memoryhandler.h"
+#include "helper/systeminfo.h"
 
 TTable TT;
 
@@ -45,11 +46,6 @@ TEntry* TCluster::probe(const uint16_t key16, bool &hit) noexcept {
 }
 
 
-constexpr TTable::TTable() noexcept :
-    clusterTable{ nullptr },
-    clusterCount{ 0 } {
-}
-
 TTable::~TTable() noexcept {
     free();
 }
@@ -80,11 +76,30 @@ bool TTable::resize(size_t memSize) {
     return true;
 }
 
-/// TTable::autoResize() set size automatically
+/// TTable::memoryBudget() returns the maximum hash size in MB that fits into the memory usable by the process,
+/// after reserving for the per-thread tables and the rest of the engine (evaluation network, stacks, ...).
+size_t TTable::memoryBudget() noexcept {
+    // Reserved memory (MB) for the rest of the engine
+    constexpr size_t ReservedSize{ 128 };
+
+    auto const memLimit{ SystemInfo::memoryLimit() >> 20 };
+    if (memLimit == 0) {
+        return MaxHashSize;
+    }
+    auto const threadSize{ (std::max(Threadpool.size(), size_t(optionThreads())) * (sizeof(Thread) + Thread::ArenaSize)) >> 20 };
+    auto const usable{ memLimit * 3 / 4 };
+    return std::clamp(usable > ReservedSize + threadSize ? usable - ReservedSize - threadSize : 0, MinHashSize, MaxHashSize);
+}
+
+/// TTable::autoResize() set size automatically, never above the memory budget
 void TTable::autoResize(size_t memSize) {
     Threadpool.stopThinking();
 
-    auto mSize{ std::clamp(memSize, MinHashSize, MaxHashSize) };
+    auto const budget{ memoryBudget() };
+    if (memSize > budget) {
+        sync_cout << "info string Hash " << memSize << " MB exceeds memory budget, using " << budget << " MB" << sync_endl;
+    }
+    auto mSize{ std::clamp(memSize, MinHashSize, budget) };
     while (mSize >= MinHashSize) {
         if (resize(mSize)) {
             return;
@@ -148,6 +163,74 @@ uint32_t TTable::hashFull() const noexcept {
     return entryCount / TCluster::EntryPerCluster;
 }
 
+TTStats& TTStats::operator+=(TTStats const &ts) noexcept {
+    clusters += ts.clusters;
+    for (uint8_t i = 0; i < TCluster::EntryPerCluster; ++i) {
+        filled[i] += ts.filled[i];
+    }
+    for (size_t d = 0; d < std::size(depths); ++d) {
+        depths[d] += ts.depths[d];
+    }
+    for (size_t a = 0; a < std::size(ages); ++a) {
+        ages[a] += ts.ages[a];
+    }
+    for (size_t b = 0; b < std::size(bounds); ++b) {
+        bounds[b] += ts.bounds[b];
+    }
+    pvs += ts.pvs;
+    return *this;
+}
+
+/// TTable::stats() scans in a multi-threaded way the clusters of the table,
+/// or only the given count of clusters evenly spread over the table (0 for all).
+TTStats TTable::stats(size_t sampleCount) const {
+    assert(clusterTable != nullptr
+        && clusterCount != 0);
+
+    sampleCount = sampleCount != 0 ? std::min(sampleCount, clusterCount) : clusterCount;
+
+    auto const threadCount{ optionThreads() };
+    std::vector<TTStats> threadStats(threadCount);
+    std::vector<std::thread> threads;
+    for (uint16_t index = 0; index < threadCount; ++index) {
+        threads.emplace_back(
+            [this, sampleCount, threadCount, index, &threadStats]() {
+
+                if (threadCount > 8) {
+                    WinProcGroup::bind(index);
+                }
+                auto &ts{ threadStats[index] };
+                // Each thread will scan its part of the samples
+                auto const stride{ sampleCount / threadCount };
+                auto const start{ stride * index };
+                auto const count{ index != threadCount - 1 ? stride : sampleCount - start };
+                for (size_t i = start; i < start + count; ++i) {
+                    auto const &tc{ clusterTable[sampleCount == clusterCount ? i :
+                                                    size_t(double(i) * clusterCount / sampleCount)] };
+                    ++ts.clusters;
+                    for (uint8_t e = 0; e < TCluster::EntryPerCluster; ++e) {
+                        auto const &te{ tc.entry[e] };
+                        if (te.depth() == DEPTH_OFFSET) {
+                            continue;
+                        }
+                        ++ts.filled[e];
+                        ++ts.depths[te.depth() - DEPTH_OFFSET];
+                        ++ts.ages[uint8_t(TEntry::Generation - te.generation()) >> 3];
+                        ++ts.bounds[te.bound()];
+                        ts.pvs += te.isPV();
+                    }
+                }
+            });
+    }
+
+    TTStats stats;
+    for (uint16_t index = 0; index < threadCount; ++index) {
+        threads[index].join();
+        stats += threadStats[index];
+    }
+    return stats;
+}
+
 /// TTable::extractNextMove() extracts next move after this move.
 Move TTable::extractNextMove(Position &pos, Move m) const noexcept {
     assert(m != MOVE_NONE
@@ -105,6 +105,21 @@ struct TCluster {
 /// Size of TCluster (32 bytes)
 static_assert(sizeof(TCluster) == 32, "Cluster size incorrect");
 
+/// TTStats are the statistics of the entries of (a sample of) the clusters of the table
+struct TTStats {
+
+    TTStats& operator+=(TTStats const&) noexcept;
+
+    uint64_t clusters{ 0 };
+    // Filled entries per cluster slot
+    uint64_t filled[TCluster::EntryPerCluster]{};
+    // Filled entries per stored depth (offset by DEPTH_OFFSET), per age (generations back), per bound
+    uint64_t depths[256]{};
+    uint64_t ages[32]{};
+    uint64_t bounds[4]{};
+    uint64_t pvs{ 0 };
+};
+
 /// Transposition::Table is an array of Cluster, of size clusterCount.
 /// Each cluster consists of EntryPerCluster number of TTEntry.
 /// Each TTEntry contains information on exactly one position.
@@ -128,6 +143,8 @@ public:
 
     void autoResize(size_t);
 
+    static size_t memoryBudget() noexcept;
+
     void clear();
 
     void free() noexcept;
@@ -137,6 +154,8 @@ public:
 
     uint32_t hashFull() const noexcept;
 
+    TTStats stats(size_t) const;
+
     Move extractNextMove(Position&, Move) const noexcept;
 
     void save(std::string_view) const;
@@ -160,6 +179,11 @@ private:
     friend std::istream& operator>>(std::istream&, TTable      &);
 };
 
+constexpr TTable::TTable() noexcept :
+    clusterTable{ nullptr },
+    clusterCount{ 0 } {
+}
+
 constexpr uint64_t mul_hi64(uint64_t a, uint64_t b) noexcept {
 
 #if defined(__GNUC__) && defined(IS_64BIT)
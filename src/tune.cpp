@@ -98,6 +98,45 @@ template<> void Tune::Entry<Score>::read_option() noexcept {
 template<> void Tune::Entry<Tune::PostUpdate>::init_option() noexcept {}
 template<> void Tune::Entry<Tune::PostUpdate>::read_option() noexcept { value(); }
 
+// Write back the directly changed parameters into their options (if any)
+static void update_option(const string &n, int v) {
+    if (Options.count(n)) {
+        Options[n] = std::to_string(v);
+    }
+}
+
+template<> void Tune::Entry<int>::add_params(std::vector<Param> &params) {
+    params.push_back({ name,
+                       [this]() { return value; },
+                       [this](int v) { value = v; update_option(name, v); },
+                       range(value) });
+}
+
+template<> void Tune::Entry<Value>::add_params(std::vector<Param> &params) {
+    params.push_back({ name,
+                       [this]() { return int(value); },
+                       [this](int v) { value = Value(v); update_option(name, v); },
+                       range(value) });
+}
+
+template<> void Tune::Entry<Score>::add_params(std::vector<Param> &params) {
+    params.push_back({ "m" + name,
+                       [this]() { return int(mgValue(value)); },
+                       [this](int v) { value = makeScore(v, egValue(value)); update_option("m" + name, v); },
+                       range(mgValue(value)) });
+    params.push_back({ "e" + name,
+                       [this]() { return int(egValue(value)); },
+                       [this](int v) { value = makeScore(mgValue(value), v); update_option("e" + name, v); },
+                       range(egValue(value)) });
+}
+
+template<> void Tune::Entry<Tune::PostUpdate>::add_params(std::vector<Param>&) {}
+
+template<> void Tune::Entry<int>::post_update() noexcept {}
+template<> void Tune::Entry<Value>::post_update() noexcept {}
+template<> void Tune::Entry<Score>::post_update() noexcept {}
+template<> void Tune::Entry<Tune::PostUpdate>::post_update() noexcept { value(); }
+
 
 // Set binary conditions according to a probability that depends
 // on the corresponding parameter value.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -94,11 +95,26 @@ class Tune {
 
     static Tune& instance() noexcept { static Tune tune; return tune; } // Singleton
 
+public:
+
+    // Param gives access to a single integer of a tuned parameter (e.g. the midgame
+    // half of a Score), so that an in-process tuner can change it directly.
+    struct Param {
+        std::string name;
+        std::function<int()> get;
+        std::function<void(int)> set;
+        Range range;
+    };
+
+private:
+
     // Use polymorphism to accomodate Entry of different types in the same vector
     struct EntryBase {
         virtual ~EntryBase() = default;
         virtual void init_option() noexcept = 0;
         virtual void read_option() noexcept = 0;
+        virtual void add_params(std::vector<Param>&) {}
+        virtual void post_update() noexcept {}
     };
 
     template<typename T>
@@ -116,6 +132,8 @@ class Tune {
         void operator=(const Entry &) = delete; // Because 'value' is a reference
         void init_option() noexcept override;
         void read_option() noexcept override;
+        void add_params(std::vector<Param>&) override;
+        void post_update() noexcept override;
 
         std::string name;
         T &value;
@@ -179,6 +197,20 @@ public:
             e->read_option();
         }
     }
+    // Integer parameters of all the entries, in the order of registration
+    static std::vector<Param> params() {
+        std::vector<Param> params;
+        for (auto &e : instance().list) {
+            e->add_params(params);
+        }
+        return params;
+    }
+    // Call the post-update functions, after the parameters have been changed directly
+    static void post_update() {
+        for (auto &e : instance().list) {
+            e->post_update();
+        }
+    }
     static bool update_on_last;
 };
 
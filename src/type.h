@@ -12,6 +12,12 @@
 ///                 | Works only in 64-bit mode and requires hardware with USE_POPCNT support.
 /// -DUSE_BMI2      | Add runtime support for use of USE_BMI2 asm-instruction.
 ///                 | Works only in 64-bit mode and requires hardware with USE_BMI2 support.
+/// -DUSE_GATHER    | Value the quiet moves with AVX2 gathers (with USE_AVX2).
+///                 | A gain only on hardware with fast gathers, so disabled by default.
+/// -DUSE_COMPACT_ATTACKS | Look up the slider attacks in deduplicated tables (about 155 KB instead of 840 KB)
+///                 | through an extra indirection. A gain when the caches are contended.
+/// -DNNUE_ARCHS   | Also load the HalfKP 128x2, 512x2 and 1024x2 nets, dispatched on the net header.
+///                 | The accumulator is sized for the widest, so disabled by default.
 
 #include <cassert>
 #include <cctype>
@@ -24,6 +30,8 @@
 #include <string>
 #include <vector>
 
+#include "helper/arena.h"
+
 /// Predefined macros hell:
 ///
 /// __GNUC__           Compiler is gcc, Clang or Intel on Linux
@@ -533,6 +541,10 @@ constexpr Move makeMove(Square org, Square dst) {
 constexpr Move reverseMove(Move m) {
     return makeMove(dstSq(m), orgSq(m));
 }
+// Move of the colour-flipped position: rank of both squares flipped, same type and promotion
+constexpr Move flipMove(Move m) {
+    return m != MOVE_NONE ? Move(m ^ 0x0E38) : MOVE_NONE;
+}
 
 /// Convert Value to Centipawn
 constexpr double toCP(Value v) {
@@ -555,20 +567,25 @@ constexpr Key makeKey(uint64_t seed) {
     return( seed * U64(6364136223846793005) + U64(1442695040888963407) );
 }
 
-class Moves :
-    public std::vector<Move> {
+template<typename Allocator>
+class BasicMoves :
+    public std::vector<Move, Allocator> {
 
 public:
-    using std::vector<Move>::vector;
+    using std::vector<Move, Allocator>::vector;
 
     bool contains(Move move) const {
-        return std::find(begin(), end(), move) != end();
+        return std::find(this->begin(), this->end(), move) != this->end();
     }
 
-    void operator+=(Move move) { push_back(move); }
-    void operator-=(Move move) { erase(std::find(begin(), end(), move)); }
+    void operator+=(Move move) { this->push_back(move); }
+    void operator-=(Move move) { this->erase(std::find(this->begin(), this->end(), move)); }
 
 };
+/// Moves for the lists that outlive a search node (search moves, game moves)
+using Moves     = BasicMoves<std::allocator<Move>>;
+/// NodeMoves for the lists of a search node, taken from the thread arena
+using NodeMoves = BasicMoves<ArenaAllocator<Move>>;
 
 struct ValMove {
 
@@ -604,11 +621,12 @@ struct ValMove {
     int32_t value;
 };
 
+/// ValMoves are generated lists, always local, so taken from the thread arena
 class ValMoves :
-    public std::vector<ValMove> {
+    public std::vector<ValMove, ArenaAllocator<ValMove>> {
 
 public:
-    using std::vector<ValMove>::vector;
+    using std::vector<ValMove, ArenaAllocator<ValMove>>::vector;
 
     void operator+=(Move move) noexcept { emplace_back(move); }
     //void operator-=(Move move) noexcept { erase(std::find(begin(), end(), move)); }
@@ -625,6 +643,11 @@ inline TimePoint now() noexcept {
     return std::chrono::duration_cast<std::chrono::milliseconds>
           (std::chrono::steady_clock::now().time_since_epoch()).count();
 }
+/// Time in nano-seconds, for fine-grained timing counters
+inline int64_t nowNS() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+          (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 /// Hash table
 template<typename T, size_t Size>
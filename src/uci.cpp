@@ -1,13 +1,27 @@
 #include "uci.h"
 
 #include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#include "pgn.h"
 #include "polyglot.h"
+#include "recorder.h"
 #include "position.h"
 #include "evaluator.h"
 #include "movegenerator.h"
@@ -15,14 +29,17 @@
 #include "thread.h"
 #include "timemanager.h"
 #include "transposition.h"
+#include "zobrist.h"
 #include "searcher.h"
 #include "skillmanager.h"
 #include "syzygytb.h"
+#include "texel.h"
 #include "helper/string.h"
 #include "helper/string_view.h"
 #include "helper/container.h"
 #include "helper/logger.h"
 #include "helper/reporter.h"
+#include "helper/systeminfo.h"
 
 using namespace std;
 
@@ -350,19 +367,26 @@ namespace UCI {
 
     namespace {
 
-        void onHash(Option const &o) noexcept {
-            TT.autoResize(o);
+        void onHash(Option const&) noexcept {
+            TT.autoResize(optionHash());
         }
 
         void onClearHash(Option const&) noexcept {
             UCI::clear();
+            Pawns::GlobalCache.clear();
         }
 
         void onSaveHash(Option const&) noexcept {
             TT.save(Options["Hash File"]);
+            Pawns::GlobalCache.save(string(string_view(Options["Hash File"])) + ".pawn");
         }
         void onLoadHash(Option const&) noexcept {
             TT.load(Options["Hash File"]);
+            Pawns::GlobalCache.load(string(string_view(Options["Hash File"])) + ".pawn");
+        }
+
+        void onPawnCache(Option const &o) noexcept {
+            Pawns::GlobalCache.resize(uint32_t(o));
         }
 
         void onBookFile(Option const &o) noexcept {
@@ -376,6 +400,22 @@ namespace UCI {
             //}
         }
 
+        void onSkillLowCPU(Option const&) noexcept {
+            auto const threadCount{ optionThreads() };
+            if (threadCount != Threadpool.size()) {
+                Threadpool.setup(threadCount); // Reallocates the hash too
+            } else
+            if (TT.size() != optionHash()) {
+                TT.autoResize(optionHash());
+            }
+        }
+        /// The strength options decide whether the low CPU skill mode applies
+        void onSkillStrength(Option const &o) noexcept {
+            if (Options["Skill Low CPU"]) {
+                onSkillLowCPU(o);
+            }
+        }
+
         void onTimeNodes(Option const&) noexcept {
             TimeMgr.clear();
         }
@@ -387,6 +427,10 @@ namespace UCI {
             StdLogger.value().setup(o);
         }
 
+        void onRecordFile(Option const &o) noexcept {
+            Recorder::open(string(string_view(o)));
+        }
+
         void onSyzygyPath(Option const &o) noexcept {
             SyzygyTB::initialize(o);
         }
@@ -401,14 +445,16 @@ namespace UCI {
 
     void initialize() noexcept {
 
-        Options["Hash"]               << Option(16, TTable::MinHashSize, TTable::MaxHashSize, onHash);
+        Options["Hash"]               << Option(16, 0, TTable::MaxHashSize, onHash);
 
         Options["Clear Hash"]         << Option(onClearHash);
         Options["Retain Hash"]        << Option(false);
+        Options["Hash Flip"]          << Option(false);
 
         Options["Hash File"]          << Option(string("Hash.dat"));
         Options["Save Hash"]          << Option(onSaveHash);
         Options["Load Hash"]          << Option(onLoadHash);
+        Options["Pawn Cache"]         << Option(0, 0, 4096, onPawnCache);
 
         Options["Use Book"]           << Option(false);
         Options["Book File"]          << Option(string("Book.bin"), onBookFile);
@@ -417,9 +463,12 @@ namespace UCI {
 
         Options["Threads"]            << Option(1, 0, 512, onThreads);
 
-        Options["Skill Level"]        << Option(MaxLevel,  0, MaxLevel);
+        Options["Skill Level"]        << Option(MaxLevel,  0, MaxLevel, onSkillStrength);
+        Options["Skill Low CPU"]      << Option(false, onSkillLowCPU);
+        Options["Skill Sleep"]        << Option(false);
 
         Options["MultiPV"]            << Option( 1, 1, 500);
+        Options["MultiPV Split"]      << Option(false);
 
         Options["Fixed Contempt"]     << Option( 24, -100, 100);
         Options["Contempt Time"]      << Option( 40,    0, 1000);
@@ -431,6 +480,7 @@ namespace UCI {
         Options["Overhead MoveTime"]  << Option( 10,  0, 5000);
         Options["Move Slowness"]      << Option(100, 10, 1000);
         Options["Ponder"]             << Option(true);
+        Options["Ponder Candidates"]  << Option(1, 1, 16);
         Options["Time Nodes"]         << Option( 0,  0, 10000, onTimeNodes);
 
         Options["SyzygyPath"]         << Option(string(""), onSyzygyPath);
@@ -445,14 +495,22 @@ namespace UCI {
 #else
         Options["Eval File"]          << Option(string("") + DefaultEvalFile, onEvalFile);
 #endif
+        Options["NNUE Eager Update"]  << Option(false);
 
         Options["Log File"]           << Option(string(""), onLogFile);
+        Options["Record File"]        << Option(string(""), onRecordFile);
+        Options["Node Timing"]        << Option(false);
+        Options["Search Stats"]       << Option(false);
+
+        Options["Info Interval"]      << Option(0, 0, 60000);
+        Options["Info Changed Lines"] << Option(false);
+        Options["Info PV Length"]     << Option(0, 0, MAX_PLY);
 
         Options["UCI_Chess960"]       << Option(false);
         Options["UCI_ShowWDL"]        << Option(false);
         Options["UCI_AnalyseMode"]    << Option(false);
-        Options["UCI_LimitStrength"]  << Option(false);
-        Options["UCI_Elo"]            << Option(1350, 1350, 3100);
+        Options["UCI_LimitStrength"]  << Option(false, onSkillStrength);
+        Options["UCI_Elo"]            << Option(1350, 1350, 3100, onSkillStrength);
 
     }
 
@@ -542,6 +600,65 @@ namespace UCI {
             sync_cout << '\n' << Evaluator::trace(cPos) << sync_endl;
         }
 
+        /// hashStats() prints the content of the TT: filled entries per cluster slot, PV flags, bounds,
+        /// ages (generations back) and depths, and the entries replaced by the last search.
+        /// hashstats [clusters] (sample of clusters spread over the table, 0 or none for all)
+        void hashStats(istringstream &iss) {
+            size_t sampleCount{ 0 };
+            iss >> sampleCount;
+
+            auto const time{ now() };
+            auto const stats{ TT.stats(sampleCount) };
+            auto const elapsed{ now() - time };
+
+            uint64_t filled{ 0 };
+            for (auto const count : stats.filled) {
+                filled += count;
+            }
+            auto const percent{ [](uint64_t count, uint64_t total) {
+                return 100.0 * count / std::max(total, uint64_t(1));
+            } };
+
+            ostringstream oss;
+            oss << std::right << std::fixed << std::setprecision(2)
+                << "\n=================================\n"
+                << "Clusters        :" << std::setw(16) << stats.clusters << '\n'
+                << "Scan time (ms)  :" << std::setw(16) << elapsed << '\n'
+                << "Filled          :" << std::setw(16) << filled << '\n'
+                << "Filled %        :" << std::setw(16) << percent(filled, stats.clusters * TCluster::EntryPerCluster) << '\n';
+            for (uint8_t e = 0; e < TCluster::EntryPerCluster; ++e) {
+                oss << "Slot " << int(e) << " filled % :" << std::setw(16) << percent(stats.filled[e], stats.clusters) << '\n';
+            }
+            oss << "PV %            :" << std::setw(16) << percent(stats.pvs, filled) << '\n'
+                << "Bound upper %   :" << std::setw(16) << percent(stats.bounds[BOUND_UPPER], filled) << '\n'
+                << "Bound lower %   :" << std::setw(16) << percent(stats.bounds[BOUND_LOWER], filled) << '\n'
+                << "Bound exact %   :" << std::setw(16) << percent(stats.bounds[BOUND_EXACT], filled) << '\n'
+                << "Bound none %    :" << std::setw(16) << percent(stats.bounds[BOUND_NONE], filled) << '\n';
+
+            // Replacements are counted with Search Stats
+            if (Threadpool.searchStats) {
+                auto const replaces{ Threadpool.accumulate(&Thread::ttReplaces) };
+                oss << "Replaced        :" << std::setw(16) << replaces << '\n'
+                    << "Replaced %      :" << std::setw(16) << percent(replaces, TT.size() * (uint64_t(1) << 20) / sizeof(TCluster) * TCluster::EntryPerCluster) << '\n';
+            }
+            oss << "---------------------------------\n"
+                << "Age             :" << std::setw(16) << "% filled" << '\n';
+            for (size_t a = 0; a < std::size(stats.ages); ++a) {
+                if (stats.ages[a] != 0) {
+                    oss << std::setw(16) << a << ':' << std::setw(16) << percent(stats.ages[a], filled) << '\n';
+                }
+            }
+            oss << "---------------------------------\n"
+                << "Depth           :" << std::setw(16) << "% filled" << '\n';
+            for (size_t d = 1; d < std::size(stats.depths); ++d) {
+                if (stats.depths[d] != 0) {
+                    oss << std::setw(16) << int32_t(d) + DEPTH_OFFSET << ':' << std::setw(16) << percent(stats.depths[d], filled) << '\n';
+                }
+            }
+            oss << "---------------------------------\n";
+            sync_cout << oss.str() << sync_endl;
+        }
+
         /// setoption() updates the UCI option ("name") to the given value ("value").
         void setOption(istringstream &iss, Position &pos) {
             string token;
@@ -678,6 +795,10 @@ namespace UCI {
         ///     * nodes
         ///     * mate
         ///     * perft
+        ///     * concurrent (nodes per instance, see benchConcurrent())
+        ///     * latency (movetime, reporting the stop latency)
+        ///     * attacks (million slider attack lookups, see benchAttacks())
+        ///     * evals (thousand static evaluations per position, see benchEvals())
         /// - FEN positions to be used in FEN format
         ///     * 'default' for builtin positions (default)
         ///     * 'current' for current position
@@ -693,21 +814,44 @@ namespace UCI {
         /// bench 64 4 5000 movetime current -> search current position with 4 threads for 5 sec (TT = 64MB)
         /// bench 64 1 100000 nodes -> search default positions for 100K nodes (TT = 64MB)
         /// bench 16 1 5 perft -> run perft 5 on default positions
-        vector<string> setupBench(istringstream &iss, Position const &pos) {
+        /// bench 16 8 1000000 concurrent -> run 8 independent searches of 1M nodes in parallel (private TT = 16MB each)
+        /// bench 16 1 4 pgkey -> compare incremental and full Polyglot key on the tree of depth 4 of default positions
+        /// bench 16 1 100 latency -> search default positions for 100 ms each, reporting how late the searches stop
+        /// bench 16 1 100 attacks -> time 100M slider attack lookups per piece type on the default positions
+        /// bench 16 1 20 evals default nnue -> time 20K NNUE evaluations of the children of each default position
+        struct BenchSetup {
+            string hash;
+            string threads;
+            string value;
+            string limit;
+            string fenFile;
+            string eval;
+        };
+
+        BenchSetup parseBench(istringstream &iss) {
             string token;
+            BenchSetup bs;
             // Assign default values to missing arguments
-            string    hash{ (iss >> token) && !whiteSpaces(token) ? token : "16" };
-            string threads{ (iss >> token) && !whiteSpaces(token) ? token : "1" };
-            string   value{ (iss >> token) && !whiteSpaces(token) ? token : "13" };
-            string   limit{ (iss >> token) && !whiteSpaces(token) ? toLower(token) : "depth" };
-            string fenFile{ (iss >> token) && !whiteSpaces(token) ? toLower(token) : "default" };
-            string    eval{ (iss >> token) && !whiteSpaces(token) ? toLower(token) : "classical" };
+            bs.hash    = (iss >> token) && !whiteSpaces(token) ? token : "16";
+            bs.threads = (iss >> token) && !whiteSpaces(token) ? token : "1";
+            bs.value   = (iss >> token) && !whiteSpaces(token) ? token : "13";
+            bs.limit   = (iss >> token) && !whiteSpaces(token) ? toLower(token) : "depth";
+            bs.fenFile = (iss >> token) && !whiteSpaces(token) ? toLower(token) : "default";
+            bs.eval    = (iss >> token) && !whiteSpaces(token) ? toLower(token) : "classical";
+            return bs;
+        }
 
-            string command{
-                limit == "eval"  ? limit :
-                limit == "perft" ? limit + " " + value :
-                                   "go " + limit + " " + value };
+        /// toNumber() returns the number of the whole argument, or the default if it is not one
+        /// (std::stoi would terminate the process on a bad argument, as exceptions are disabled).
+        template<typename T>
+        T toNumber(string const &str, T defaultValue) {
+            istringstream iss{ str };
+            T value;
+            return (iss >> value) && (iss >> std::ws).eof() ? value : defaultValue;
+        }
 
+        /// readFens() returns the FEN positions (and setoption commands) of the bench
+        vector<string> readFens(string const &fenFile, Position const &pos) {
             vector<string> fens;
             if (fenFile == "default") {
                 fens = DefaultFens;
@@ -728,6 +872,18 @@ namespace UCI {
                     std::cerr << "ERROR: unable to open file ... \'" << fenFile << "\'\n";
                 }
             }
+            return fens;
+        }
+
+        vector<string> setupBench(BenchSetup const &bs, Position const &pos) {
+            auto const &[hash, threads, value, limit, fenFile, eval]{ bs };
+
+            string command{
+                limit == "eval"  ? limit :
+                limit == "perft" ? limit + " " + value :
+                                   "go " + limit + " " + value };
+
+            auto const fens{ readFens(fenFile, pos) };
 
             bool uciChess960{ Options["UCI_Chess960"] };
 
@@ -768,11 +924,365 @@ namespace UCI {
             return uciCmds;
         }
 
+        /// benchConcurrent() runs 'threads' independent single-threaded fixed-node searches in parallel,
+        /// each on its own root position from the bench list, to measure the throughput of the whole socket
+        /// (memory bandwidth, L3 sharing, turbo) as with many engines per host.
+        /// Instances keep searching until the slowest one has searched its nodes, so the load stays constant.
+        /// Each instance probes a private table of 'hash' MB, as a separate engine would, the global TT is left as it is.
+        void benchConcurrent(BenchSetup const &bs, Position &pos) {
+
+            uint16_t const instanceCount( std::clamp(toNumber(bs.threads, 1), 1, 512) );
+            uint64_t const nodes( std::max(toNumber(bs.value, int64_t(1000000)), int64_t(1000)) );
+            size_t   const hash( std::clamp(toNumber(bs.hash, 16), int(TTable::MinHashSize), int(TTable::MaxHashSize)) );
+
+            // Chess960 positions are skipped, moves after the FEN are dropped
+            vector<string> fens;
+            bool chess960{ false };
+            for (auto const &fen : readFens(bs.fenFile, pos)) {
+                if (fen.find("setoption") != string::npos) {
+                    chess960 = fen.find("UCI_Chess960 value true") != string::npos;
+                    continue;
+                }
+                if (chess960) {
+                    continue;
+                }
+                string const fenPart{ fen.substr(0, fen.find(" moves")) };
+
+                StateInfo si;
+                Position p;
+                p.setup(fenPart, si, Threadpool.mainThread());
+                if (MoveList<LEGAL>(p).size() != 0) {
+                    fens.push_back(fenPart);
+                }
+            }
+            if (fens.empty()) {
+                std::cerr << "ERROR: no position to search\n";
+                return;
+            }
+
+            for (string const &cmd : {
+                    "setoption name Threads value " + std::to_string(instanceCount),
+                    string("setoption name Use NNUE value ") + (bs.eval == "nnue" ? "true" : "false") }) {
+                istringstream iss{ cmd };
+                string token;
+                iss >> token;
+                setOption(iss, pos);
+            }
+            UCI::clear();
+
+            std::unique_ptr<TTable[]> tables{ new TTable[instanceCount] };
+            for (uint16_t i = 0; i < instanceCount; ++i) {
+                if (!tables[i].resize(hash)) {
+                    return;
+                }
+            }
+            for (uint16_t i = 0; i < instanceCount; ++i) {
+                Threadpool[i]->tTable = &tables[i];
+            }
+
+            TimeMgr.startTime = now();
+            Limits.clear();
+            Threadpool.startConcurrent(fens, nodes);
+            Threadpool.mainThread()->waitIdle();
+            Threadpool.concurrentNodes = 0;
+
+            for (auto *th : Threadpool) {
+                th->tTable = &TT;
+            }
+
+            uint64_t totalNodes{ 0 };
+            TimePoint maxTime{ 1 };
+            double sumNPS{ 0.0 },
+                   minNPS{ 0.0 },
+                   maxNPS{ 0.0 };
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Instance       Nodes   Time (ms)  Nodes/second  Position\n";
+            for (uint16_t i = 0; i < instanceCount; ++i) {
+                auto const time{ Threadpool.concurrentTimes[i] };
+                auto const count{ Threadpool.concurrentCounts[i] };
+                double const nps{ count * 1000.0 / time };
+
+                totalNodes += count;
+                maxTime = std::max(time, maxTime);
+                sumNPS += nps;
+                minNPS = i == 0 ? nps : std::min(nps, minNPS);
+                maxNPS = i == 0 ? nps : std::max(nps, maxNPS);
+
+                oss << std::setw(8) << i + 1
+                    << std::setw(12) << count
+                    << std::setw(12) << time
+                    << std::setw(14) << uint64_t(nps)
+                    << "  " << fens[i % fens.size()] << '\n';
+            }
+            oss << "---------------------------------\n"
+                << "Instances       :" << std::setw(16) << instanceCount << '\n'
+                << "Nodes/instance  :" << std::setw(16) << nodes << '\n'
+                << "Total time (ms) :" << std::setw(16) << maxTime << '\n'
+                << "Nodes searched  :" << std::setw(16) << totalNodes << '\n'
+                << "Nodes/second    :" << std::setw(16) << uint64_t(sumNPS) << '\n'
+                << "NPS/instance avg:" << std::setw(16) << uint64_t(sumNPS / instanceCount) << '\n'
+                << "NPS/instance min:" << std::setw(16) << uint64_t(minNPS) << '\n'
+                << "NPS/instance max:" << std::setw(16) << uint64_t(maxNPS)
+                << "\n---------------------------------\n";
+            std::cerr << oss.str() << '\n';
+
+            istringstream iss{ "name Use NNUE value " + Options["Use NNUE"].defaultValue() };
+            setOption(iss, pos);
+        }
+
+        /// walkPGKeys() walks the legal move tree to the depth, returning the xor of the Polyglot keys of all its nodes
+        template<bool Incremental>
+        Key walkPGKeys(Position &pos, Depth depth, uint64_t &nodes) {
+            ++nodes;
+            Key key{ Incremental ? pos.pgKey() : PolyZob.computePosiKey(pos) };
+            if (depth > DEPTH_ZERO) {
+                StateInfo si;
+                for (auto const &vm : MoveList<LEGAL>(pos)) {
+                    pos.doMove(vm, si);
+                    key ^= walkPGKeys<Incremental>(pos, depth - 1, nodes);
+                    pos.undoMove(vm);
+                }
+            }
+            return key;
+        }
+
+        /// benchPGKey() walks the move tree of the bench positions twice, reading the incrementally updated
+        /// Polyglot key and recomputing it from the board, the difference of time is the cost of the recomputation.
+        void benchPGKey(BenchSetup const &bs, Position const &pos) {
+
+            Depth const depth( std::clamp(toNumber(bs.value, 4), 1, 6) );
+
+            uint64_t nodes[2]{ 0, 0 };
+            TimePoint times[2]{ 0, 0 };
+            Key keys[2]{ 0, 0 };
+            bool chess960{ false };
+            bool const uciChess960{ Options["UCI_Chess960"] };
+            for (auto const &fen : readFens(bs.fenFile, pos)) {
+                if (fen.find("setoption") != string::npos) {
+                    chess960 = fen.find("UCI_Chess960 value true") != string::npos;
+                    continue;
+                }
+                Options["UCI_Chess960"] = toString(chess960);
+
+                StateInfo si;
+                Position p;
+                p.setup(fen.substr(0, fen.find(" moves")), si, Threadpool.mainThread());
+
+                auto time{ nowNS() };
+                keys[0] ^= walkPGKeys<false>(p, depth, nodes[0]);
+                times[0] += nowNS() - time;
+
+                time = nowNS();
+                keys[1] ^= walkPGKeys<true>(p, depth, nodes[1]);
+                times[1] += nowNS() - time;
+            }
+            Options["UCI_Chess960"] = toString(uciChess960);
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Nodes           :" << std::setw(16) << nodes[1] << '\n'
+                << "Full (ms)       :" << std::setw(16) << times[0] / 1000000 << '\n'
+                << "Incremental (ms):" << std::setw(16) << times[1] / 1000000 << '\n'
+                << "ns/node full    :" << std::setw(16) << double(times[0]) / std::max(nodes[0], uint64_t(1)) << '\n'
+                << "ns/node incr    :" << std::setw(16) << double(times[1]) / std::max(nodes[1], uint64_t(1)) << '\n'
+                << "ns/key saved    :" << std::setw(16) << (double(times[0]) - double(times[1])) / std::max(nodes[1], uint64_t(1)) << '\n'
+                << "Keys match      :" << std::setw(16) << (keys[0] == keys[1] ? "yes" : "NO")
+                << "\n---------------------------------\n";
+            std::cerr << oss.str() << '\n';
+        }
+
+        /// benchAttacks() times the slider attack lookups on the occupancy of the bench positions,
+        /// from every square, 'value' million lookups per piece type.
+        /// The tables stay hot in the cache here, so this is the cost of the lookup itself
+        /// (e.g. the extra indirection of USE_COMPACT_ATTACKS), the cache pressure shows in the bench nps.
+        void benchAttacks(BenchSetup const &bs, Position const &pos) {
+
+            uint64_t const count{ uint64_t(std::max(toNumber(bs.value, int64_t(13)), int64_t(1))) * 1000000 };
+
+            vector<Bitboard> occupancies;
+            bool const uciChess960{ Options["UCI_Chess960"] };
+            for (auto const &fen : readFens(bs.fenFile, pos)) {
+                if (fen.find("setoption") != string::npos) {
+                    Options["UCI_Chess960"] = toString(fen.find("UCI_Chess960 value true") != string::npos);
+                    continue;
+                }
+                StateInfo si;
+                Position p;
+                p.setup(fen.substr(0, fen.find(" moves")), si, Threadpool.mainThread());
+                occupancies.push_back(p.pieces());
+            }
+            Options["UCI_Chess960"] = toString(uciChess960);
+            if (occupancies.empty()) {
+                return;
+            }
+
+            Bitboard checksum{ 0 };
+            auto const timeLookups{ [&](auto lookup) {
+                auto const time{ nowNS() };
+                uint64_t n{ 0 };
+                while (n < count) {
+                    for (auto const occ : occupancies) {
+                        for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+                            checksum += lookup(s, occ);
+                        }
+                    }
+                    n += occupancies.size() * SQUARES;
+                }
+                return double(nowNS() - time) / n;
+            } };
+
+            double const bshpTime{ timeLookups([](Square s, Bitboard occ) { return attacksBB<BSHP>(s, occ); }) };
+            double const rookTime{ timeLookups([](Square s, Bitboard occ) { return attacksBB<ROOK>(s, occ); }) };
+            double const quenTime{ timeLookups([](Square s, Bitboard occ) { return attacksBB<QUEN>(s, occ); }) };
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+#if defined(USE_COMPACT_ATTACKS)
+                << "Layout          :" << std::setw(16) << "compact" << '\n'
+#else
+                << "Layout          :" << std::setw(16) << "full" << '\n'
+#endif
+                << "Tables (KB)     :" << std::setw(16) << Bitboards::attacksSize() / 1024 << '\n'
+                << "Occupancies     :" << std::setw(16) << occupancies.size() << '\n'
+                << "ns/lookup bshp  :" << std::setw(16) << bshpTime << '\n'
+                << "ns/lookup rook  :" << std::setw(16) << rookTime << '\n'
+                << "ns/lookup quen  :" << std::setw(16) << quenTime << '\n'
+                << "Checksum        :" << std::setw(16) << std::hex << checksum << std::dec
+                << "\n---------------------------------\n";
+            std::cerr << oss.str() << '\n';
+        }
+
+        /// evalCount() returns the static evaluations per position of the evals bench, 'value' thousand
+        uint64_t evalCount(BenchSetup const &bs) {
+            return uint64_t(std::max(toNumber(bs.value, int64_t(13)), int64_t(1))) * 1000;
+        }
+
+        /// evalTimes() times 'value' thousand static evaluations per bench position, over its legal children
+        /// not in check, each evaluated right after its move so that NNUE updates the accumulator incrementally
+        /// as in the search. Returns the ns per evaluation of each position (0 without such children).
+        vector<double> evalTimes(BenchSetup const &bs, Position &pos) {
+
+            uint64_t const count{ evalCount(bs) };
+
+            istringstream iss{ string("name Use NNUE value ") + (bs.eval == "nnue" ? "true" : "false") };
+            setOption(iss, pos);
+
+            vector<double> times;
+            int64_t checksum{ 0 };
+            bool const uciChess960{ Options["UCI_Chess960"] };
+            for (auto const &fen : readFens(bs.fenFile, pos)) {
+                if (fen.find("setoption") != string::npos) {
+                    Options["UCI_Chess960"] = toString(fen.find("UCI_Chess960 value true") != string::npos);
+                    continue;
+                }
+                StateInfo si;
+                Position p;
+                p.setup(fen.substr(0, fen.find(" moves")), si, Threadpool.mainThread());
+
+                Moves moves;
+                for (auto const &vm : MoveList<LEGAL>(p)) {
+                    if (!p.giveCheck(vm)) {
+                        moves.push_back(vm);
+                    }
+                }
+                if (moves.empty()
+                 || p.checkers() != 0) {
+                    times.push_back(0.0);
+                    continue;
+                }
+                // The children are evaluated from the accumulator of the root
+                checksum += Evaluator::evaluate(p);
+
+                StateInfo csi;
+                auto const time{ nowNS() };
+                uint64_t n{ 0 };
+                while (n < count) {
+                    for (auto const m : moves) {
+                        p.doMove(m, csi);
+                        checksum += Evaluator::evaluate(p);
+                        p.undoMove(m);
+                    }
+                    n += moves.size();
+                }
+                times.push_back(double(nowNS() - time) / n);
+            }
+            Options["UCI_Chess960"] = toString(uciChess960);
+
+            iss.clear();
+            iss.str("name Use NNUE value " + Options["Use NNUE"].defaultValue());
+            setOption(iss, pos);
+
+            // Keep the evaluations from being optimized away
+            if (checksum == INT64_MIN) {
+                std::cerr << "Checksum " << checksum << '\n';
+            }
+            return times;
+        }
+
+        /// benchEvals() reports the time of the static evaluations of the bench positions (see evalTimes()).
+        void benchEvals(BenchSetup const &bs, Position &pos) {
+
+            auto const fens{ readFens(bs.fenFile, pos) };
+            auto const times{ evalTimes(bs, pos) };
+
+            double sumTime{ 0.0 };
+            uint16_t posCount{ 0 };
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Position   ns/eval  FEN\n";
+            uint16_t i{ 0 };
+            for (auto const &fen : fens) {
+                if (fen.find("setoption") != string::npos) {
+                    continue;
+                }
+                auto const time{ times[i++] };
+                if (time != 0.0) {
+                    sumTime += time;
+                    ++posCount;
+                }
+                oss << std::setw(8) << i
+                    << std::setw(10) << std::fixed << std::setprecision(1) << time
+                    << "  " << fen << '\n';
+            }
+            oss << "---------------------------------\n"
+                << "Positions       :" << std::setw(16) << posCount << '\n'
+                << "Evals/position  :" << std::setw(16) << evalCount(bs) << '\n'
+                << "ns/static eval  :" << std::setw(16) << std::fixed << std::setprecision(1) << sumTime / std::max(posCount, uint16_t(1))
+                << "\n---------------------------------\n";
+            std::cerr << oss.str() << '\n';
+        }
+
         /// bench() setup list of UCI commands is setup according to bench parameters,
         /// then it is run one by one printing a summary at the end.
         void bench(istringstream &isstream, Position &pos, StateListPtr &states) {
 
-            auto const uciCmds{ setupBench(isstream, pos) };
+            auto const bs{ parseBench(isstream) };
+            if (bs.limit == "concurrent") {
+                benchConcurrent(bs, pos);
+                return;
+            }
+            if (bs.limit == "pgkey") {
+                benchPGKey(bs, pos);
+                return;
+            }
+            if (bs.limit == "attacks") {
+                benchAttacks(bs, pos);
+                return;
+            }
+            if (bs.limit == "evals") {
+                benchEvals(bs, pos);
+                return;
+            }
+
+            // Latency searches with movetime, measuring how late they stop
+            bool const latency{ bs.limit == "latency" };
+            auto const uciCmds{ setupBench(latency ? BenchSetup{ bs.hash, bs.threads, bs.value, "movetime", bs.fenFile, bs.eval } : bs, pos) };
             auto const cmdCount{ std::count_if(uciCmds.begin(), uciCmds.end(),
                                             [](string const &s) {
                                                 return s.find("eval") == 0
@@ -783,6 +1293,16 @@ namespace UCI {
             Reporter::reset();
             TimePoint elapsed{ now() };
             uint64_t nodes{ 0 };
+            NodeTiming timing;
+            timing.clear();
+            MoveOrdering ordering;
+            ordering.clear();
+            vector<int64_t> overshoots; // Stop latency (ns) of the movetime searches
+            int64_t newGameTime{ 0 };
+            uint64_t infoBlocks{ 0 };
+            uint64_t infoTime{ 0 };
+            uint64_t ttHits{ 0 };
+            bool nnueUsed{ false };
             int32_t i{ 0 };
             for (auto const &cmd : uciCmds) {
                 istringstream iss{ cmd };
@@ -806,9 +1326,29 @@ namespace UCI {
                         perft<true>(pos, depth);
                     } else
                     if (token == "go") {
+                        auto const goTime{ nowNS() };
                         go(iss, pos, states);
                         Threadpool.mainThread()->waitIdle();
+                        nnueUsed |= Evaluator::useNNUE;
+                        // Searches ended before the time (mate, single move) have no stop latency
+                        if (latency
+                         && nowNS() - goTime + 1000000 >= Limits.moveTime * 1000000) {
+                            overshoots.push_back(nowNS() - goTime - Limits.moveTime * 1000000);
+                        }
                         nodes += Threadpool.accumulate(&Thread::nodes);
+                        ttHits += Threadpool.accumulate(&Thread::ttHits);
+                        infoBlocks += Threadpool.mainThread()->infoBlocks;
+                        infoTime   += Threadpool.mainThread()->infoTime;
+                        for (auto const *th : Threadpool) {
+                            timing.evalCount  += th->timing.evalCount;
+                            timing.evalTime   += th->timing.evalTime;
+                            timing.eagerCount += th->timing.eagerCount;
+                            timing.eagerTime  += th->timing.eagerTime;
+                            timing.pickTime       += th->timing.pickTime;
+                            timing.quietValueTime += th->timing.quietValueTime;
+                            timing.sortTime       += th->timing.sortTime;
+                            ordering += th->ordering;
+                        }
                     }
                 } else
                 if (token == "setoption") {
@@ -818,7 +1358,9 @@ namespace UCI {
                     position(iss, pos, states);
                 } else
                 if (token == "ucinewgame") {
+                    newGameTime = nowNS();
                     UCI::clear();
+                    newGameTime = nowNS() - newGameTime;
                     elapsed = now();
                 } else {
                     //std::cerr << "Unknown token : " << token << '\n';
@@ -829,15 +1371,862 @@ namespace UCI {
 
             Reporter::print(); // Just before exiting
 
+            uint64_t const pawnCacheProbes{ Threadpool.accumulate(&Thread::pawnCacheProbes) };
+            uint64_t const pawnCacheHits{ Threadpool.accumulate(&Thread::pawnCacheHits) };
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Total time (ms) :" << std::setw(16) << elapsed << '\n'
+                << "Nodes searched  :" << std::setw(16) << nodes << '\n'
+                << "Nodes/second    :" << std::setw(16) << nodes * 1000 / elapsed << '\n';
+            if (Threadpool.searchStats) {
+                oss << "TT hits/node %  :" << std::setw(16) << std::fixed << std::setprecision(2) << ttHits * 100.0 / std::max(nodes, uint64_t(1)) << '\n';
+            }
+            oss << "ucinewgame (us) :" << std::setw(16) << newGameTime / 1000 << '\n'
+                << "Info blocks     :" << std::setw(16) << infoBlocks << '\n'
+                << "Info output (us):" << std::setw(16) << infoTime / 1000 << '\n'
+                << "Info output %   :" << std::setw(16) << std::fixed << std::setprecision(3) << infoTime / (elapsed * 10000.0)
+                << "\n---------------------------------\n";
+            if (nnueUsed) {
+                // The nps of the architectures are compared by running bench with their nets
+                oss << "NNUE network    : " << Evaluator::NNUE::architecture()
+                    << "\n---------------------------------\n";
+            }
+            if (timing.evalCount != 0) {
+                oss << "Static evals    :" << std::setw(16) << timing.evalCount << '\n'
+                    << "ns/static eval  :" << std::setw(16) << timing.evalTime / timing.evalCount << '\n'
+                    << "ns/node in eval :" << std::setw(16) << timing.evalTime / std::max(nodes, uint64_t(1)) << '\n'
+                    << "Eager updates   :" << std::setw(16) << timing.eagerCount << '\n'
+                    << "ns/eager update :" << std::setw(16) << timing.eagerTime / std::max(timing.eagerCount, uint64_t(1)) << '\n'
+                    << "ns/node eval+eag:" << std::setw(16) << (timing.evalTime + timing.eagerTime) / std::max(nodes, uint64_t(1)) << '\n'
+                    << "ns/node         :" << std::setw(16) << elapsed * 1000000 / std::max(nodes, uint64_t(1)) << '\n'
+                    << "ns/node picking :" << std::setw(16) << timing.pickTime / std::max(nodes, uint64_t(1)) << '\n'
+                    << "Quiet value %   :" << std::setw(16) << std::fixed << std::setprecision(2) << timing.quietValueTime * 100.0 / std::max(timing.pickTime, uint64_t(1)) << '\n'
+                    << "Partial sort %  :" << std::setw(16) << std::fixed << std::setprecision(2) << timing.sortTime * 100.0 / std::max(timing.pickTime, uint64_t(1))
+                    << "\n---------------------------------\n";
+            }
+            if (ordering.nodes != 0) {
+                constexpr char const *StageNames[PICK_STAGES]{
+                    "TT move", "Good captures", "Refutations", "Quiets", "Bad captures", "Evasions", "Other" };
+
+                uint64_t cuts{ 0 };
+                for (uint8_t ps = 0; ps < PICK_STAGES; ++ps) {
+                    cuts += ordering.cuts[ps];
+                }
+                oss << std::fixed << std::setprecision(2)
+                    << "Move ordering      Cut-offs  Share %  Avg index\n";
+                for (uint8_t ps = 0; ps < PICK_STAGES; ++ps) {
+                    if (ordering.cuts[ps] != 0) {
+                        oss << std::left  << std::setw(16) << StageNames[ps]
+                            << std::right << std::setw(11) << ordering.cuts[ps]
+                            << std::setw(9)  << ordering.cuts[ps] * 100.0 / cuts
+                            << std::setw(11) << double(ordering.cutIndex[ps]) / ordering.cuts[ps] << '\n';
+                    }
+                }
+                oss << "---------------------------------\n"
+                    << "Cut-off nodes % :" << std::setw(16) << cuts * 100.0 / ordering.nodes << '\n'
+                    << "First move cut %:" << std::setw(16) << ordering.firstCuts * 100.0 / std::max(cuts, uint64_t(1)) << '\n'
+                    << "TT move nodes % :" << std::setw(16) << ordering.ttNodes * 100.0 / ordering.nodes << '\n'
+                    << "TT move cut %   :" << std::setw(16) << ordering.ttCuts * 100.0 / std::max(ordering.ttNodes, uint64_t(1))
+                    << "\n---------------------------------\n";
+            }
+            if (pawnCacheProbes != 0) {
+                oss << "Pawn table miss :" << std::setw(16) << pawnCacheProbes << '\n'
+                    << "Pawn cache hits :" << std::setw(16) << pawnCacheHits << '\n'
+                    << "Pawn cache hit %:" << std::setw(16) << std::fixed << std::setprecision(2) << pawnCacheHits * 100.0 / pawnCacheProbes
+                    << "\n---------------------------------\n";
+            }
+            if (!overshoots.empty()) {
+                std::sort(overshoots.begin(), overshoots.end());
+                auto const percentile{ [&](size_t p) {
+                    return overshoots[std::min(overshoots.size() * p / 100, overshoots.size() - 1)] / 1000;
+                } };
+                oss << "Stop latency (us), movetime " << bs.value << " ms\n"
+                    << "Searches        :" << std::setw(16) << overshoots.size() << '\n'
+                    << "Tick interval   :" << std::setw(16) << Threadpool.mainThread()->tickLimit << '\n'
+                    << "Mean            :" << std::setw(16) << std::accumulate(overshoots.begin(), overshoots.end(), int64_t(0)) / int64_t(overshoots.size()) / 1000 << '\n'
+                    << "Min             :" << std::setw(16) << overshoots.front() / 1000 << '\n'
+                    << "Median          :" << std::setw(16) << percentile(50) << '\n'
+                    << "90th percentile :" << std::setw(16) << percentile(90) << '\n'
+                    << "99th percentile :" << std::setw(16) << percentile(99) << '\n'
+                    << "Max             :" << std::setw(16) << overshoots.back() / 1000
+                    << "\n---------------------------------\n";
+            }
+        #if defined(ALLOC_COUNT)
+            uint64_t heapAllocs{ 0 };
+            uint64_t arenaOverflows{ 0 };
+            size_t arenaPeak{ 0 };
+            for (auto const *th : Threadpool) {
+                heapAllocs     += th->arena.heapAllocs;
+                arenaOverflows += th->arena.overflows;
+                arenaPeak       = std::max(th->arena.peak, arenaPeak);
+            }
+            oss << "Heap allocs     :" << std::setw(16) << heapAllocs << '\n'
+                << "Heap allocs/node:" << std::setw(16) << std::fixed << std::setprecision(6) << double(heapAllocs) / std::max(nodes, uint64_t(1)) << '\n'
+                << "Arena peak (KB) :" << std::setw(16) << (arenaPeak >> 10) << '\n'
+                << "Arena overflows :" << std::setw(16) << arenaOverflows
+                << "\n---------------------------------\n";
+        #endif
+            std::cerr << oss.str() << '\n';
+        }
+
+        /// readPGN() reads all the games of a PGN file in parallel and reports the throughput.
+        /// pgn <file> [threads]
+        void readPGN(istringstream &iss) {
+            string filename;
+            iss >> std::quoted(filename);
+            uint16_t threadCount{ uint16_t(Threadpool.size()) };
+            iss >> threadCount;
+
+            TimePoint elapsed{ now() };
+            auto const stats{ PGN::read(filename, threadCount) };
+            elapsed = std::max(now() - elapsed, { 1 }); // Ensure non-zero to avoid a 'divide by zero'
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Total time (ms) :" << std::setw(16) << elapsed << '\n'
+                << "Size (MB)       :" << std::setw(16) << (stats.bytes >> 20) << '\n'
+                << "Games           :" << std::setw(16) << stats.games << '\n'
+                << "Moves           :" << std::setw(16) << stats.moves << '\n'
+                << "Errors          :" << std::setw(16) << stats.errors << '\n'
+                << "Games/second    :" << std::setw(16) << stats.games * 1000 / elapsed << '\n'
+                << "Moves/second    :" << std::setw(16) << stats.moves * 1000 / elapsed
+                << "\n---------------------------------\n";
+            std::cerr << oss.str() << '\n';
+        }
+
+        /// tune() tunes the TUNE() parameters of the classical evaluation on a set of labelled positions.
+        /// texel <file> [threads] [iterations] [result file]
+        void tune(istringstream &iss) {
+            string filename;
+            iss >> std::quoted(filename);
+            uint16_t threadCount{ uint16_t(Threadpool.size()) };
+            iss >> threadCount;
+            uint32_t iterations{ 100 };
+            iss >> iterations;
+            string resultFile;
+            iss >> std::quoted(resultFile);
+
+            Texel::tune(filename, threadCount, iterations, resultFile);
+        }
+
+        /// replay() feeds the commands of a record (see Recorder) back to the engine and compares
+        /// the performance of the replayed searches with the recorded ones.
+        /// 'stop' and 'ponderhit' are sent with the same delay after their 'go' as recorded,
+        /// the other commands as soon as the search is idle (the time between moves doesn't matter).
+        /// replay <file>
+        void replay(istringstream &isstream, Position &pos, StateListPtr &states) {
+            string filename;
+            isstream >> std::quoted(filename);
+
+            vector<std::pair<TimePoint, string>> commands;
+            vector<Recorder::Summary> recorded;
+            if (!Recorder::read(filename, commands, recorded)) {
+                return;
+            }
+
+            Recorder::startReplay();
+            TimePoint goRecordTime{ 0 },
+                      goReplayTime{ 0 };
+            for (auto const &[time, cmd] : commands) {
+                istringstream iss{ cmd };
+                string token;
+                iss >> std::skipws >> token;
+                token = toLower(token);
+
+                if (token == "stop"
+                 || token == "ponderhit") {
+                    auto const delay{ goReplayTime + (time - goRecordTime) - now() };
+                    if (delay > 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+                    }
+                } else {
+                    Threadpool.mainThread()->waitIdle();
+                }
+                Recorder::input(cmd);
+
+                if (token == "stop") {
+                    Threadpool.stop = true;
+                    Threadpool.budgetStop = false;
+                } else
+                if (token == "ponderhit") {
+                    Threadpool.ponderhit();
+                } else
+                if (token == "ucinewgame") {
+                    UCI::clear();
+                } else
+                if (token == "position") {
+                    position(iss, pos, states);
+                } else
+                if (token == "go") {
+                    goRecordTime = time;
+                    goReplayTime = now();
+                    go(iss, pos, states);
+                } else
+                if (token == "setoption") {
+                    setOption(iss, pos);
+                }
+            }
+            Threadpool.mainThread()->waitIdle();
+            auto const replayed{ Recorder::stopReplay() };
+
+            uint64_t nodes[2]{ 0, 0 };
+            TimePoint times[2]{ 0, 0 };
+            uint32_t stopDiffs{ 0 },
+                     moveDiffs{ 0 };
             ostringstream oss;
             oss << std::right
                 << "\n=================================\n"
+                << "Search  Depth     Rec Nodes     Rep Nodes  Rec ms  Rep ms  Rec/Rep stop       Rec/Rep move\n";
+            auto const count{ std::min(recorded.size(), replayed.size()) };
+            for (size_t i = 0; i < count; ++i) {
+                auto const &rec{ recorded[i] };
+                auto const &rep{ replayed[i] };
+                nodes[0] += rec.nodes; times[0] += rec.time;
+                nodes[1] += rep.nodes; times[1] += rep.time;
+                stopDiffs += rec.stop != rep.stop;
+                moveDiffs += rec.bestMove != rep.bestMove;
+
+                oss << std::setw(6) << i + 1
+                    << std::setw(4) << rec.depth << '/' << std::left << std::setw(3) << rep.depth << std::right
+                    << std::setw(13) << rec.nodes
+                    << std::setw(14) << rep.nodes
+                    << std::setw(8) << rec.time
+                    << std::setw(8) << rep.time
+                    << std::setw(10) << rec.stop << '/' << std::left << std::setw(8) << rep.stop << std::right
+                    << std::setw(8) << rec.bestMove << '/' << rep.bestMove << '\n';
+            }
+            oss << "---------------------------------\n"
+                << "Searches        :" << std::setw(16) << count << '\n'
+                << "Rec nodes       :" << std::setw(16) << nodes[0] << '\n'
+                << "Rep nodes       :" << std::setw(16) << nodes[1] << '\n'
+                << "Rec time (ms)   :" << std::setw(16) << times[0] << '\n'
+                << "Rep time (ms)   :" << std::setw(16) << times[1] << '\n'
+                << "Rec nodes/second:" << std::setw(16) << nodes[0] * 1000 / std::max(times[0], { 1 }) << '\n'
+                << "Rep nodes/second:" << std::setw(16) << nodes[1] * 1000 / std::max(times[1], { 1 }) << '\n'
+                << "Stop diffs      :" << std::setw(16) << stopDiffs << '\n'
+                << "Bestmove diffs  :" << std::setw(16) << moveDiffs
+                << "\n---------------------------------\n";
+            if (recorded.size() != replayed.size()) {
+                oss << "Searches recorded " << recorded.size() << ", replayed " << replayed.size() << '\n';
+            }
+            std::cerr << oss.str() << '\n';
+        }
+
+        /// readOptional() reads the next token into the value only if it is a number (optional argument),
+        /// else leaves it in the stream, without setting the stream to fail.
+        template<typename T>
+        void readOptional(istringstream &iss, T &value) {
+            iss >> std::ws;
+            if (std::isdigit(iss.peek())) {
+                iss >> value;
+            }
+        }
+
+        /// analyse() annotates a game: searches every position of it with the same limit and reports
+        /// per ply the evaluation, the best move, the loss of the played move and its blunder flag.
+        /// The positions are searched from the last move backwards (unless 'forward') with the same TT,
+        /// so the results of the later positions are found again in the earlier ones and speed them up.
+        /// The game is the moves played from the current position or the N-th game of a PGN file.
+        /// analyse [depth|nodes|movetime <value>] [forward] [pgn <file> [game]] [moves <move>...]
+        void analyse(istringstream &iss, Position &pos, StateListPtr &states) {
+            string limit{ "depth" };
+            uint64_t limitValue{ 12 };
+            bool forward{ false };
+            string fen{ pos.fen() };
+            Moves moves;
+
+            string token;
+            while (iss >> token) {
+                if (token == "depth"
+                 || token == "nodes"
+                 || token == "movetime") {
+                    limit = token;
+                    readOptional(iss, limitValue);
+                } else
+                if (token == "forward") {
+                    forward = true;
+                } else
+                if (token == "pgn") {
+                    string filename;
+                    iss >> std::quoted(filename);
+                    uint64_t gameNo{ 1 };
+                    readOptional(iss, gameNo);
+
+                    uint64_t count{ 0 };
+                    std::optional<PGN::Game> game;
+                    // Single parsing thread to keep the games in the order of the file
+                    PGN::read(filename, 1, [&](PGN::Game const &g) {
+                        if (++count == gameNo) {
+                            game = g;
+                        }
+                    });
+                    if (!game) {
+                        std::cerr << "ERROR: no game " << gameNo << " in '" << filename << "'\n";
+                        return;
+                    }
+                    fen = game->fen;
+                    moves = game->moves;
+                } else
+                if (token == "moves") {
+                    StateListPtr setupStates{ new StateList{ 1 } };
+                    Position setupPos;
+                    setupPos.setup(fen, setupStates->back(), Threadpool.mainThread());
+                    while (iss >> token) {
+                        auto const m{ moveOfCAN(token, setupPos) };
+                        if (m == MOVE_NONE) {
+                            std::cerr << "ERROR: Illegal Move '" << token << "'\n";
+                            return;
+                        }
+                        moves += m;
+                        setupStates->emplace_back();
+                        setupPos.doMove(m, setupStates->back());
+                    }
+                }
+            }
+
+            // Command setting up the position after the first 'ply' moves of the game
+            auto const positionCmd{ [&](size_t ply) {
+                ostringstream oss;
+                oss << "fen " << fen << " moves";
+                for (size_t i = 0; i < ply; ++i) {
+                    oss << ' ' << moveToCAN(moves[i]);
+                }
+                return oss.str();
+            } };
+
+            struct PlyResult {
+                Move  bestMove{ MOVE_NONE };
+                Value value{ VALUE_NONE };  // For the side to move
+            };
+            vector<PlyResult> results(moves.size() + 1);
+
+            UCI::clear();
+            uint64_t nodes{ 0 };
+            TimePoint elapsed{ now() };
+            for (size_t i = 0; i <= moves.size(); ++i) {
+                auto const ply{ forward ? i : moves.size() - i };
+
+                istringstream issPos{ positionCmd(ply) };
+                position(issPos, pos, states);
+
+                if (MoveList<LEGAL>(pos).size() == 0) {
+                    results[ply].value = pos.checkers() != 0 ? -VALUE_MATE : VALUE_DRAW;
+                    continue;
+                }
+
+                istringstream issGo{ limit + " " + std::to_string(limitValue) };
+                go(issGo, pos, states);
+                Threadpool.mainThread()->waitIdle();
+
+                // With the MultiPV split the main thread holds the merged PV lines (see ThreadPool::splitBestThread())
+                auto const *th{ Threadpool.size() > 1
+                             && Threadpool.pvCount == 1 ? Threadpool.bestThread() : Threadpool.mainThread() };
+                auto const &rm{ th->rootMoves[0] };
+                results[ply].bestMove = rm[0];
+                results[ply].value = rm.newValue != -VALUE_INFINITE ? rm.newValue : rm.oldValue;
+                nodes += Threadpool.accumulate(&Thread::nodes);
+            }
+            elapsed = std::max(now() - elapsed, { 1 }); // Ensure non-zero to avoid a 'divide by zero'
+
+            // Values for the loss are bounded to keep the mates comparable
+            auto const bounded{ [](Value v) {
+                return std::clamp(v, Value(-10 * VALUE_EG_PAWN), Value(+10 * VALUE_EG_PAWN));
+            } };
+
+            uint32_t flagCounts[3]{ 0, 0, 0 };
+            ostringstream oss;
+            oss << std::right
+                << "   Ply  Move     Flag  Best            Eval    Played    Loss\n";
+            StateListPtr gameStates{ new StateList{ 1 } };
+            Position gamePos;
+            gamePos.setup(fen, gameStates->back(), Threadpool.mainThread());
+            for (size_t ply = 0; ply < moves.size(); ++ply) {
+                auto const m{ moves[ply] };
+                auto const &res{ results[ply] };
+                // Values from the point of view of White, the loss from the point of view of the mover
+                auto const sign{ gamePos.activeSide() == WHITE ? +1 : -1 };
+                auto const playedValue{ -results[ply + 1].value };
+                // The best move loses nothing, even if its own search has found a different value
+                auto const loss{ m == res.bestMove ? 0 : std::max(int32_t(toCP(bounded(res.value) - bounded(playedValue))), 0) };
+                auto const flag{ loss >= 300 ? 2 : loss >= 100 ? 1 : loss >= 50 ? 0 : -1 };
+                if (flag >= 0) {
+                    ++flagCounts[flag];
+                }
+
+                oss << std::setw(6) << ply + 1 << "  "
+                    << std::left
+                    << std::setw(9) << moveToSAN(m, gamePos)
+                    << std::setw(6) << (flag == 2 ? "??" : flag == 1 ? "?" : flag == 0 ? "?!" : "")
+                    << std::setw(9) << (res.bestMove != MOVE_NONE ? moveToSAN(res.bestMove, gamePos) : "-")
+                    << std::right
+                    << std::setw(11) << toString(Value(sign * res.value))
+                    << std::setw(10) << toString(Value(sign * playedValue))
+                    << std::setw(8) << loss << '\n';
+
+                gameStates->emplace_back();
+                gamePos.doMove(m, gameStates->back());
+            }
+            sync_cout << oss.str() << sync_endl;
+
+            oss.str("");
+            oss << std::right
+                << "\n=================================\n"
+                << "Order           :" << std::setw(16) << (forward ? "forward" : "reverse") << '\n'
+                << "Limit           :" << std::setw(16) << (limit + " " + std::to_string(limitValue)) << '\n'
                 << "Total time (ms) :" << std::setw(16) << elapsed << '\n'
+                << "Positions       :" << std::setw(16) << results.size() << '\n'
                 << "Nodes searched  :" << std::setw(16) << nodes << '\n'
-                << "Nodes/second    :" << std::setw(16) << nodes * 1000 / elapsed
+                << "Nodes/second    :" << std::setw(16) << nodes * 1000 / elapsed << '\n'
+                << "Positions/second:" << std::setw(16) << std::fixed << std::setprecision(2) << double(results.size()) * 1000 / elapsed << '\n'
+                << "Inaccuracies ?! :" << std::setw(16) << flagCounts[0] << '\n'
+                << "Mistakes ?      :" << std::setw(16) << flagCounts[1] << '\n'
+                << "Blunders ??     :" << std::setw(16) << flagCounts[2]
                 << "\n---------------------------------\n";
             std::cerr << oss.str() << '\n';
         }
+
+        /// incompleteBeta() is the regularized incomplete beta function I_x(a, b), by its continued fraction (modified Lentz).
+        double incompleteBeta(double a, double b, double x) {
+            if (x <= 0.0) {
+                return 0.0;
+            }
+            if (x >= 1.0) {
+                return 1.0;
+            }
+            // The continued fraction converges fast only below the mean
+            if (x > (a + 1.0) / (a + b + 2.0)) {
+                return 1.0 - incompleteBeta(b, a, 1.0 - x);
+            }
+            double const front{ std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x)) / a };
+
+            constexpr double Tiny{ 1.0e-30 };
+            double f{ 1.0 }, c{ 1.0 }, d{ 0.0 };
+            for (int32_t i = 0; i <= 400; ++i) {
+                int32_t const m{ i / 2 };
+                double const numerator{
+                    i == 0     ? 1.0 :
+                    i % 2 == 0 ? (m * (b - m) * x) / ((a + 2.0 * m - 1.0) * (a + 2.0 * m)) :
+                                 -((a + m) * (a + b + m) * x) / ((a + 2.0 * m) * (a + 2.0 * m + 1.0)) };
+
+                d = 1.0 + numerator * d;
+                d = 1.0 / (std::abs(d) < Tiny ? Tiny : d);
+                c = 1.0 + numerator / c;
+                c = std::abs(c) < Tiny ? Tiny : c;
+                f *= c * d;
+                if (std::abs(1.0 - c * d) < 1.0e-12) {
+                    break;
+                }
+            }
+            return front * (f - 1.0);
+        }
+
+        /// tTestPValue() returns the two-sided p-value of the Student t statistic with the degrees of freedom.
+        double tTestPValue(double t, double dof) {
+            return incompleteBeta(dof / 2.0, 0.5, dof / (dof + t * t));
+        }
+
+        /// PairedTest is the paired Student t-test of the differences b - a of two series:
+        /// the mean difference with its 95% confidence interval, the t statistic and the two-sided p-value.
+        struct PairedTest {
+
+            PairedTest(vector<double> const &a, vector<double> const &b) {
+                auto const n{ a.size() };
+                vector<double> diffs(n);
+                for (size_t i = 0; i < n; ++i) {
+                    diffs[i] = b[i] - a[i];
+                }
+                mean = std::accumulate(diffs.begin(), diffs.end(), 0.0) / n;
+                double var{ 0.0 };
+                for (auto const d : diffs) {
+                    var += (d - mean) * (d - mean);
+                }
+                var /= std::max(n - 1, size_t(1));
+                double const se{ std::sqrt(var / n) };
+                double const dof(std::max(n - 1, size_t(1)));
+
+                // Critical value of the 95% interval, by bisection on the p-value
+                double lo{ 0.0 }, hi{ 1000.0 };
+                for (int32_t i = 0; i < 100; ++i) {
+                    double const mid{ (lo + hi) / 2 };
+                    (tTestPValue(mid, dof) > 0.05 ? lo : hi) = mid;
+                }
+                low  = mean - hi * se;
+                high = mean + hi * se;
+                t = se != 0.0 ? mean / se : 0.0;
+                p = se != 0.0 ? tTestPValue(t, dof) : mean == 0.0 ? 1.0 : 0.0;
+            }
+
+            string interval(int32_t precision) const {
+                ostringstream oss;
+                oss << std::fixed << std::setprecision(precision) << low << ".." << high;
+                return oss.str();
+            }
+
+            double mean, low, high, t, p;
+        };
+
+        /// SpeedConfig is a side of the speedtest: options of this engine, or a binary run as a child process.
+        struct SpeedConfig {
+            string binary;
+            vector<std::pair<string, string>> options;
+        };
+
+        /// SpeedRun is a run of the bench workload: per position the nodes and time (ms) of the search
+        /// and the time (ns) of a static evaluation, 0 if not measured.
+        struct SpeedRun {
+
+            double nps() const {
+                return std::accumulate(nodes.begin(), nodes.end(), 0.0) * 1000
+                     / std::max(std::accumulate(times.begin(), times.end(), 0.0), 1.0);
+            }
+
+            double evalTime() const {
+                double const count( std::count_if(evalTimes.begin(), evalTimes.end(), [](double t) { return t != 0.0; }) );
+                return std::accumulate(evalTimes.begin(), evalTimes.end(), 0.0) / std::max(count, 1.0);
+            }
+
+            vector<uint64_t> nodes;
+            vector<double>   times;
+            vector<double>   evalTimes;
+        };
+
+        /// speedRunEngine() runs the bench workload in this engine with the options of the config,
+        /// the options set only by the other config are set back to their value before the speedtest.
+        SpeedRun speedRunEngine(SpeedConfig const &config, vector<std::pair<string, string>> const &defaults,
+                                BenchSetup const &bs, uint64_t evals, Position &pos, StateListPtr &states) {
+
+            for (auto const &[name, value] : defaults) {
+                auto const itr{ std::find_if(config.options.begin(), config.options.end(),
+                                            [&](auto const &option) { return option.first == name; }) };
+                istringstream iss{ "name " + name + " value " + (itr != config.options.end() ? itr->second : value) };
+                setOption(iss, pos);
+            }
+
+            SpeedRun run;
+            for (auto const &cmd : setupBench(bs, pos)) {
+                istringstream iss{ cmd };
+                string token;
+                iss >> std::skipws >> token;
+
+                if (token == "go") {
+                    auto const time{ nowNS() };
+                    go(iss, pos, states);
+                    Threadpool.mainThread()->waitIdle();
+                    run.times.push_back((nowNS() - time) / 1000000.0);
+                    run.nodes.push_back(Threadpool.accumulate(&Thread::nodes));
+                } else
+                if (token == "setoption") {
+                    setOption(iss, pos);
+                } else
+                if (token == "position") {
+                    position(iss, pos, states);
+                } else
+                if (token == "ucinewgame") {
+                    UCI::clear();
+                }
+            }
+            if (evals != 0) {
+                run.evalTimes = evalTimes(BenchSetup{ bs.hash, bs.threads, std::to_string(evals), "evals", bs.fenFile, bs.eval }, pos);
+            }
+            return run;
+        }
+
+        /// tempFileName() returns the name of a new temporary file, unique so that the speedtests
+        /// run at the same time (or from the same directory) don't overwrite each other's files.
+        /// Empty if no file could be created.
+        string tempFileName() {
+            string name;
+        #if defined(_WIN32)
+            auto *const tmpName{ _tempnam(nullptr, "DON_speedtest_") };
+            if (tmpName != nullptr) {
+                name = tmpName;
+                std::free(tmpName);
+            }
+        #else
+            auto const *const tmpDir{ std::getenv("TMPDIR") };
+            name = string(tmpDir != nullptr ? tmpDir : "/tmp") + "/DON_speedtest_XXXXXX";
+            auto const fd{ mkstemp(name.data()) };
+            if (fd == -1) {
+                return string{};
+            }
+            close(fd);
+        #endif
+            return name;
+        }
+
+        /// speedRunBinary() runs the bench workload in a child process of the binary of the config,
+        /// feeding it the UCI commands from a file and reading the searches from its info lines
+        /// and the evaluations from its 'bench evals' table (missing with binaries without it).
+        SpeedRun speedRunBinary(SpeedConfig const &config, BenchSetup const &bs, uint64_t evals) {
+
+            SpeedRun run;
+            string const cmdFile{ tempFileName() };
+            if (cmdFile.empty()) {
+                std::cerr << "ERROR: unable to create a temporary file\n";
+                return run;
+            }
+            std::ofstream ofstream{ cmdFile, std::ios::out };
+            for (auto const &[name, value] : config.options) {
+                ofstream << "setoption name " << name << " value " << value << '\n';
+            }
+            ofstream << "bench " << bs.hash << ' ' << bs.threads << ' ' << bs.value << ' ' << bs.limit << ' ' << bs.fenFile << ' ' << bs.eval << '\n';
+            if (evals != 0) {
+                ofstream << "bench " << bs.hash << ' ' << bs.threads << ' ' << evals << " evals " << bs.fenFile << ' ' << bs.eval << '\n';
+            }
+            ofstream << "quit\n";
+            ofstream.close();
+
+            string command{ "\"" + config.binary + "\" < " + cmdFile + " 2>&1" };
+        #if defined(_WIN32)
+            // cmd.exe strips the outer quotes
+            command = "\"" + command + "\"";
+            auto *pipe{ _popen(command.c_str(), "r") };
+        #else
+            auto *pipe{ popen(command.c_str(), "r") };
+        #endif
+            if (pipe == nullptr) {
+                std::cerr << "ERROR: unable to run \'" << config.binary << "\'\n";
+                std::remove(cmdFile.c_str());
+                return run;
+            }
+
+            uint64_t nodes{ 0 };
+            double time{ 0.0 };
+            bool evalTable{ false };
+            string line;
+            char buffer[4096];
+            while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+                line += buffer;
+                if (line.back() != '\n') {
+                    continue;
+                }
+                istringstream iss{ line };
+                line.clear();
+                string token;
+                iss >> token;
+
+                // The last info line of a search has its nodes and time
+                if (token == "info") {
+                    while (iss >> token) {
+                        if (token == "nodes") {
+                            iss >> nodes;
+                        } else
+                        if (token == "time") {
+                            iss >> time;
+                        }
+                    }
+                } else
+                if (token == "bestmove") {
+                    run.nodes.push_back(nodes);
+                    run.times.push_back(time);
+                    nodes = 0;
+                    time = 0.0;
+                } else
+                if (token == "Position") {
+                    evalTable = true;
+                } else
+                if (evalTable) {
+                    double evalTime;
+                    if (token.find("---") == 0) {
+                        evalTable = false;
+                    } else
+                    if (iss >> evalTime) {
+                        run.evalTimes.push_back(evalTime);
+                    }
+                }
+            }
+        #if defined(_WIN32)
+            _pclose(pipe);
+        #else
+            pclose(pipe);
+        #endif
+            std::remove(cmdFile.c_str());
+            return run;
+        }
+
+        /// speedtest() compares the speed of two configs A and B on the bench workload, each either options
+        /// of this engine or a binary run as a child process over UCI (both binaries for the fairest comparison).
+        /// The runs are interleaved A B B A A B ... so that a linear drift of the speed (heat, turbo) cancels out,
+        /// and paired by round for the t-test of the difference of nps and of static evaluation time.
+        /// Reports per position the nodes, the nps and the ns per static evaluation of A and B,
+        /// then the mean differences with their 95% confidence interval and p-value.
+        /// speedtest [runs <n>] [evals <thousands>] [a|b [binary <path>] [name <option> value <value>]...] [bench <args>...]
+        void speedtest(istringstream &iss, Position &pos, StateListPtr &states) {
+            uint16_t runs{ 10 };
+            uint64_t evals{ 20 };
+            SpeedConfig configs[2];
+            BenchSetup bs{ "16", "1", "13", "depth", "default", "classical" };
+
+            string token;
+            SpeedConfig *config{ nullptr };
+            bool optionValue{ false };
+            while (iss >> token) {
+                if (token == "runs") {
+                    iss >> runs;
+                    config = nullptr;
+                } else
+                if (token == "evals") {
+                    iss >> evals;
+                    config = nullptr;
+                } else
+                if (token == "a"
+                 || token == "b") {
+                    config = &configs[token == "b"];
+                } else
+                if (token == "bench") {
+                    bs = parseBench(iss);
+                    break;
+                } else
+                if (config != nullptr) {
+                    if (token == "binary") {
+                        iss >> std::quoted(config->binary);
+                    } else
+                    if (token == "name") {
+                        config->options.emplace_back();
+                        optionValue = false;
+                    } else
+                    if (token == "value") {
+                        optionValue = true;
+                    } else
+                    if (!config->options.empty()) {
+                        auto &str{ optionValue ? config->options.back().second : config->options.back().first };
+                        str += (str.empty() ? "" : " ") + token;
+                    }
+                }
+            }
+            if (bs.limit != "depth"
+             && bs.limit != "nodes"
+             && bs.limit != "movetime") {
+                std::cerr << "ERROR: speedtest needs a depth, nodes or movetime bench\n";
+                return;
+            }
+            runs = std::max(runs, uint16_t(2));
+
+            // Values before the speedtest of the options set in this engine
+            vector<std::pair<string, string>> defaults;
+            for (auto const &cfg : configs) {
+                if (!cfg.binary.empty()) {
+                    continue;
+                }
+                for (auto const &[name, value] : cfg.options) {
+                    if (contains(Options, name)
+                     && std::none_of(defaults.begin(), defaults.end(), [&](auto const &d) { return d.first == name; })) {
+                        defaults.emplace_back(name, string(std::string_view(Options[name])));
+                    }
+                }
+            }
+
+            vector<SpeedRun> results[2];
+            for (uint16_t r = 0; r < runs; ++r) {
+                for (uint8_t i = 0; i < 2; ++i) {
+                    uint8_t const c( (r % 2) ^ i );
+                    std::cerr << "\nSpeedtest round " << r + 1 << '/' << runs << ": " << "AB"[c] << '\n';
+                    results[c].push_back(configs[c].binary.empty() ?
+                        speedRunEngine(configs[c], defaults, bs, evals, pos, states) :
+                        speedRunBinary(configs[c], bs, evals));
+                }
+            }
+            for (auto const &[name, value] : defaults) {
+                istringstream is{ "name " + name + " value " + value };
+                setOption(is, pos);
+            }
+
+            auto const posCount{ results[0][0].nodes.size() };
+            for (auto const &run : results) {
+                for (auto const &rr : run) {
+                    if (rr.nodes.size() != posCount
+                     || posCount == 0) {
+                        std::cerr << "ERROR: the runs of A and B searched different positions\n";
+                        return;
+                    }
+                }
+            }
+            bool const evalTimed{ std::all_of(std::begin(results), std::end(results), [&](auto const &rs) {
+                return std::all_of(rs.begin(), rs.end(), [&](auto const &rr) { return rr.evalTimes.size() == posCount; }); }) };
+
+            ostringstream oss;
+            oss << std::right
+                << "\n=================================\n"
+                << "Position     Nodes A     Nodes B       NPS A       NPS B  Diff %  ns/eval A  ns/eval B  Diff %\n";
+            for (size_t p = 0; p < posCount; ++p) {
+                double nodes[2]{ 0.0, 0.0 },
+                       times[2]{ 0.0, 0.0 },
+                       evalT[2]{ 0.0, 0.0 };
+                for (uint8_t c = 0; c < 2; ++c) {
+                    for (auto const &rr : results[c]) {
+                        nodes[c] += rr.nodes[p];
+                        times[c] += rr.times[p];
+                        evalT[c] += evalTimed ? rr.evalTimes[p] / runs : 0.0;
+                    }
+                }
+                double const nps[2]{ nodes[0] * 1000 / std::max(times[0], 1.0), nodes[1] * 1000 / std::max(times[1], 1.0) };
+                oss << std::setw(8) << p + 1
+                    << std::setw(12) << uint64_t(nodes[0] / runs)
+                    << std::setw(12) << uint64_t(nodes[1] / runs)
+                    << std::setw(12) << uint64_t(nps[0])
+                    << std::setw(12) << uint64_t(nps[1])
+                    << std::setw(8) << std::fixed << std::setprecision(2) << (nps[0] != 0.0 ? (nps[1] / nps[0] - 1) * 100 : 0.0);
+                if (evalTimed
+                 && evalT[0] != 0.0
+                 && evalT[1] != 0.0) {
+                    oss << std::setw(11) << std::setprecision(1) << evalT[0]
+                        << std::setw(11) << std::setprecision(1) << evalT[1]
+                        << std::setw(8) << std::setprecision(2) << (evalT[0] / evalT[1] - 1) * 100;
+                } else {
+                    oss << std::setw(11) << '-'
+                        << std::setw(11) << '-'
+                        << std::setw(8) << '-';
+                }
+                oss << '\n';
+            }
+
+            // Paired by round: the nps and its relative difference (speedup of B over A)
+            vector<double> nps[2], speedups[2];
+            for (uint16_t r = 0; r < runs; ++r) {
+                nps[0].push_back(results[0][r].nps());
+                nps[1].push_back(results[1][r].nps());
+                speedups[0].push_back(0.0);
+                speedups[1].push_back((nps[1][r] / nps[0][r] - 1) * 100);
+            }
+            PairedTest const npsTest{ nps[0], nps[1] };
+            PairedTest const speedupTest{ speedups[0], speedups[1] };
+
+            oss << "---------------------------------\n"
+                << "A               :" << std::setw(16) << (configs[0].binary.empty() ? "engine" : configs[0].binary) << '\n'
+                << "B               :" << std::setw(16) << (configs[1].binary.empty() ? "engine" : configs[1].binary) << '\n'
+                << "Rounds          :" << std::setw(16) << runs << '\n'
+                << "Nodes/second A  :" << std::setw(16) << uint64_t(std::accumulate(nps[0].begin(), nps[0].end(), 0.0) / runs) << '\n'
+                << "Nodes/second B  :" << std::setw(16) << uint64_t(std::accumulate(nps[1].begin(), nps[1].end(), 0.0) / runs) << '\n'
+                << "NPS diff        :" << std::setw(16) << int64_t(npsTest.mean) << '\n'
+                << "NPS diff 95% CI :" << std::setw(16) << npsTest.interval(0) << '\n'
+                << "Speedup %       :" << std::setw(16) << std::fixed << std::setprecision(2) << speedupTest.mean << '\n'
+                << "Speedup 95% CI %:" << std::setw(16) << speedupTest.interval(2) << '\n'
+                << "t statistic     :" << std::setw(16) << std::setprecision(3) << npsTest.t << '\n'
+                << "p-value         :" << std::setw(16) << std::setprecision(4) << npsTest.p
+                << "\n---------------------------------\n";
+            if (evalTimed) {
+                vector<double> evalSpeedups[2];
+                double evalTime[2]{ 0.0, 0.0 };
+                for (uint16_t r = 0; r < runs; ++r) {
+                    evalTime[0] += results[0][r].evalTime() / runs;
+                    evalTime[1] += results[1][r].evalTime() / runs;
+                    evalSpeedups[0].push_back(0.0);
+                    evalSpeedups[1].push_back((results[0][r].evalTime() / std::max(results[1][r].evalTime(), 1.0e-9) - 1) * 100);
+                }
+                PairedTest const evalTest{ evalSpeedups[0], evalSpeedups[1] };
+
+                oss << "ns/static eval A:" << std::setw(16) << std::setprecision(1) << evalTime[0] << '\n'
+                    << "ns/static eval B:" << std::setw(16) << std::setprecision(1) << evalTime[1] << '\n'
+                    << "Eval speedup %  :" << std::setw(16) << std::setprecision(2) << evalTest.mean << '\n'
+                    << "Eval 95% CI %   :" << std::setw(16) << evalTest.interval(2) << '\n'
+                    << "Eval p-value    :" << std::setw(16) << std::setprecision(4) << evalTest.p
+                    << "\n---------------------------------\n";
+            }
+            std::cerr << oss.str() << '\n';
+        }
     }
 
     /// handleCommands() waits for a command from stdin, parses it and calls the appropriate function.
@@ -874,15 +2263,20 @@ namespace UCI {
             iss >> std::skipws >> token;
             token = toLower(token);
 
+            if (token != "replay") {
+                Recorder::input(cmd);
+            }
+
             if (token == "quit"
              || token == "stop") {
                 Threadpool.stop = true;
+                Threadpool.budgetStop = false;
             } else
             // GUI sends 'ponderhit' to tell that the opponent has played the expected move.
             // So 'ponderhit' will be sent if told to ponder on the same move the opponent has played.
             // Now should continue searching but switch from pondering to normal search.
             if (token == "ponderhit") {
-                Threadpool.ponder = false; // Switch to normal search
+                Threadpool.ponderhit(); // Switch to normal search
             } else
             if (token == "isready") {
                 sync_cout << "readyok" << sync_endl;
@@ -933,6 +2327,24 @@ namespace UCI {
 
                 perft<true>(pos, depth, detail);
             } else
+            if (token == "pgn") {
+                readPGN(iss);
+            } else
+            if (token == "texel") {
+                tune(iss);
+            } else
+            if (token == "replay") {
+                replay(iss, pos, states);
+            } else
+            if (token == "analyse") {
+                analyse(iss, pos, states);
+            } else
+            if (token == "speedtest") {
+                speedtest(iss, pos, states);
+            } else
+            if (token == "hashstats") {
+                hashStats(iss);
+            } else
             if (token == "keys") {
                 ostringstream oss;
                 oss << "FEN: " << pos.fen() << '\n'
@@ -1025,10 +2437,47 @@ namespace UCI {
 
 }
 
+/// optionSkillLevel() returns the skill level, from the Elo if the strength is limited
+double optionSkillLevel() {
+    return Options["UCI_LimitStrength"] ?
+            std::clamp(std::pow((double(Options["UCI_Elo"]) - 1346.6) / 143.4, 1 / 0.806), 0.0, double(MaxLevel)) :
+            double(Options["Skill Level"]);
+}
+
+/// optionLowCPU() tells whether the low CPU skill mode applies, only while the strength is limited
+bool optionLowCPU() {
+    return Options["Skill Low CPU"]
+        && optionSkillLevel() < MaxLevel;
+}
+
+/// optionThreads() returns the number of threads, 0 means auto:
+/// as many as processors usable by the process (affinity mask and cgroup cpu quota).
 uint16_t optionThreads() {
     uint16_t threadCount{ Options["Threads"] };
     if (threadCount == 0) {
-        threadCount = uint16_t(std::thread::hardware_concurrency());
+        threadCount = std::min(SystemInfo::cpuCount(), uint16_t(512));
+    }
+    // Low CPU skill mode plays with a single thread
+    if (optionLowCPU()) {
+        threadCount = 1;
     }
     return threadCount;
 }
+
+/// optionHash() returns the hash size in MB, 0 means auto:
+/// half of the memory budget but at most 64 MB per thread, rounded down to a power of 2.
+size_t optionHash() {
+    size_t hashSize{ Options["Hash"] };
+    if (hashSize == 0) {
+        auto const mSize{ std::min(TTable::memoryBudget() / 2, size_t(64) * optionThreads()) };
+        hashSize = TTable::MinHashSize;
+        while (hashSize * 2 <= mSize) {
+            hashSize *= 2;
+        }
+    }
+    // Low CPU skill mode plays with a small hash
+    if (optionLowCPU()) {
+        hashSize = std::min(hashSize, LowCPUHashSize);
+    }
+    return hashSize;
+}
@@ -84,4 +84,7 @@ namespace UCI {
 // Global nocase mapping of Options
 extern UCI::OptionMap Options;
 
+extern double optionSkillLevel();
+extern bool optionLowCPU();
 extern uint16_t optionThreads();
+extern size_t optionHash();
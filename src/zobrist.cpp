@@ -45,6 +45,26 @@ Key Zobrist::computePosiKey(Position const &pos) const noexcept {
     return posiKey;
 }
 
+/// Zobrist::computeFlipKey() computes hash key of the colour-flipped position (White and Black swapped),
+/// ignoring the castling rights (to be flipped as well otherwise), so valid only without them.
+Key Zobrist::computeFlipKey(Position const &pos) const noexcept {
+    Key flipKey{ 0 };
+    for (Piece const p : Pieces) {
+        Square const *ps{ pos.squares(p) };
+        Square s;
+        while ((s = *ps++) != SQ_NONE) {
+            flipKey ^= flipPsq(p, s);
+        }
+    }
+    if (pos.activeSide() == BLACK) {
+        flipKey ^= side;
+    }
+    flipKey ^= castling[CR_NONE];
+    // Same file, same key
+    flipKey ^= enpassantKey(pos.epSquare());
+    return flipKey;
+}
+
 namespace Zobrists {
 
     /// initialize() initializes Zobrist lookup tables.
@@ -16,9 +16,12 @@ struct Zobrist {
     Key computeMatlKey(Position const&) const noexcept;
     Key computePawnKey(Position const&) const noexcept;
     Key computePosiKey(Position const&) const noexcept;
+    Key computeFlipKey(Position const&) const noexcept;
 
 
     Key enpassantKey(Square epSq) const noexcept { return epSq != SQ_NONE ? enpassant[sFile(epSq)] : 0; }
+    // Key of the piece on the square in the colour-flipped position
+    Key flipPsq(Piece p, Square s) const noexcept { return psq[flipColor(p)][flip<Rank>(s)]; }
 
     // 15*64 + 16 + 8 + 1 = 985
     // 12*64 + 16 + 8 + 1 = 793